@@ -3,29 +3,57 @@
  * PROJECT #4: BALANCED PARENTHESES CHECKER & EXPRESSION VALIDATOR
  * ============================================================================
  * Data Structure: Stack
- * Features: Multi-bracket validation, error position detection, suggestions
+ * Features: Multi-bracket validation, error position detection, suggestions,
+ *           silent batch validation with a worker thread pool
  * ============================================================================
  */
 
 #include <iostream>
-#include <stack>
 #include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
 using namespace std;
 
+// Outcome codes for silent (machine-readable) validation
+enum ValidationStatus {
+    BALANCED = 0,
+    UNEXPECTED_CLOSING = 1,
+    MISMATCHED = 2,
+    UNCLOSED = 3
+};
+
+// Compact result of validating one expression (12 bytes)
+struct ValidationResult {
+    unsigned char status;       // ValidationStatus
+    char bracket;               // Offending bracket ('\0' when balanced)
+    unsigned int position;      // Index of the offending character
+    unsigned int openPosition;  // Index of the unmatched opening bracket
+};
+
+
 class ParenthesesChecker {
 private:
-    stack<char> brackets;
-    stack<int> positions;
+    // Single preallocated stack of open brackets (bracket + its position),
+    // reused across calls so validation does not allocate per expression
+    struct OpenBracket {
+        char bracket;
+        unsigned int position;
+    };
+    vector<OpenBracket> openStack;
 
-    bool isOpening(char ch) {
+    static bool isOpening(char ch) {
         return ch == '(' || ch == '{' || ch == '[' || ch == '<';
     }
 
-    bool isClosing(char ch) {
+    static bool isClosing(char ch) {
         return ch == ')' || ch == '}' || ch == ']' || ch == '>';
     }
 
-    bool matches(char open, char close) {
+    static bool matches(char open, char close) {
         return (open == '(' && close == ')') ||
                (open == '{' && close == '}') ||
                (open == '[' && close == ']') ||
@@ -33,53 +61,107 @@ private:
     }
 
 public:
-    bool validate(const string& expression) {
-        // Clear stacks
-        while (!brackets.empty()) brackets.pop();
-        while (!positions.empty()) positions.pop();
+    explicit ParenthesesChecker(size_t expectedDepth = 64) {
+        openStack.reserve(expectedDepth);
+    }
+
+    // Silent validation: no output, no allocation once the stack has grown
+    ValidationResult check(const char* expression, size_t length) {
+        openStack.clear();
+        ValidationResult result = {BALANCED, '\0', 0, 0};
 
-        for (size_t i = 0; i < expression.length(); i++) {
+        for (size_t i = 0; i < length; i++) {
             char ch = expression[i];
 
             if (isOpening(ch)) {
-                brackets.push(ch);
-                positions.push(i);
+                OpenBracket entry = {ch, (unsigned int)i};
+                openStack.push_back(entry);
             }
             else if (isClosing(ch)) {
-                if (brackets.empty()) {
-                    cout << "\n❌ Error at position " << i << ": Unexpected closing bracket '" << ch << "'" << endl;
-                    cout << "   " << expression << endl;
-                    cout << "   " << string(i, ' ') << "^" << endl;
-                    return false;
+                if (openStack.empty()) {
+                    result.status = UNEXPECTED_CLOSING;
+                    result.bracket = ch;
+                    result.position = (unsigned int)i;
+                    return result;
                 }
 
-                char top = brackets.top();
-                if (!matches(top, ch)) {
-                    cout << "\n❌ Error at position " << i << ": Mismatched brackets!" << endl;
-                    cout << "   Expected '" << getClosing(top) << "' but found '" << ch << "'" << endl;
-                    cout << "   " << expression << endl;
-                    cout << "   " << string(positions.top(), ' ') << "^" << string(i - positions.top() - 1, ' ') << "^" << endl;
-                    return false;
+                const OpenBracket& top = openStack.back();
+                if (!matches(top.bracket, ch)) {
+                    result.status = MISMATCHED;
+                    result.bracket = ch;
+                    result.position = (unsigned int)i;
+                    result.openPosition = top.position;
+                    return result;
                 }
 
-                brackets.pop();
-                positions.pop();
+                openStack.pop_back();
             }
         }
 
-        if (!brackets.empty()) {
-            cout << "\n❌ Error: Unclosed bracket '" << brackets.top() << "' at position " << positions.top() << endl;
-            cout << "   " << expression << endl;
-            cout << "   " << string(positions.top(), ' ') << "^" << endl;
-            cout << "   Suggestion: Add '" << getClosing(brackets.top()) << "' at the end" << endl;
-            return false;
+        if (!openStack.empty()) {
+            result.status = UNCLOSED;
+            result.bracket = openStack.back().bracket;
+            result.position = openStack.back().position;
+            result.openPosition = openStack.back().position;
+        }
+        return result;
+    }
+
+    ValidationResult check(const string& expression) {
+        return check(expression.data(), expression.length());
+    }
+
+    // Silent batch API: validates inputs[0..count) into results[0..count)
+    void validateBatch(const string* inputs, size_t count, ValidationResult* results) {
+        for (size_t i = 0; i < count; i++) {
+            results[i] = check(inputs[i]);
+        }
+    }
+
+    vector<ValidationResult> validateBatch(const vector<string>& inputs) {
+        vector<ValidationResult> results(inputs.size());
+        if (!inputs.empty()) {
+            validateBatch(&inputs[0], inputs.size(), &results[0]);
+        }
+        return results;
+    }
+
+    bool validate(const string& expression) {
+        ValidationResult result = check(expression);
+        size_t i = result.position;
+
+        switch (result.status) {
+            case UNEXPECTED_CLOSING:
+                cout << "\n❌ Error at position " << i << ": Unexpected closing bracket '" << result.bracket << "'" << endl;
+                cout << "   " << expression << endl;
+                cout << "   " << string(i, ' ') << "^" << endl;
+                return false;
+
+            case MISMATCHED: {
+                char top = expression[result.openPosition];
+                cout << "\n❌ Error at position " << i << ": Mismatched brackets!" << endl;
+                cout << "   Expected '" << getClosing(top) << "' but found '" << result.bracket << "'" << endl;
+                cout << "   " << expression << endl;
+                cout << "   " << string(result.openPosition, ' ') << "^" << string(i - result.openPosition - 1, ' ') << "^" << endl;
+                return false;
+            }
+
+            case UNCLOSED:
+                cout << "\n❌ Error: Unclosed bracket '" << result.bracket << "' at position " << i << endl;
+                cout << "   " << expression << endl;
+                cout << "   " << string(i, ' ') << "^" << endl;
+                cout << "   Suggestion: Add '" << getClosing(result.bracket) << "' at the end" << endl;
+                return false;
+
+            default:
+                break;
         }
 
         cout << "\n✅ Expression is perfectly balanced!" << endl;
         return true;
     }
 
-    char getClosing(char open) {
+    static char getClosing(char open) {
         switch(open) {
             case '(': return ')';
             case '{': return '}';
@@ -121,6 +203,166 @@ public:
     }
 };
 
+// ============================================================================
+// BATCH VALIDATOR - Fixed-size thread pool for large batches
+// ============================================================================
+// Workers are started once and sleep between batches. Each worker owns its
+// own ParenthesesChecker (and therefore its own preallocated stack) and
+// claims fixed-size chunks of the batch through an atomic counter.
+class BatchValidator {
+private:
+    vector<thread> workers;
+    mutex submitMutex; // Held for a whole validateBatch call: one batch at a time
+    mutex mtx;
+    condition_variable workReady;
+    condition_variable workDone;
+
+    // Current batch (valid while activeWorkers > 0)
+    const string* batchInputs;
+    ValidationResult* batchResults;
+    size_t batchSize;
+    size_t chunkSize;
+    atomic<size_t> nextChunk;
+
+    unsigned long generation;
+    size_t activeWorkers;
+    bool stopping;
+
+    ParenthesesChecker inlineChecker; // Used when the pool has no workers
+
+    void runChunks(ParenthesesChecker& checker) {
+        while (true) {
+            size_t begin = nextChunk.fetch_add(chunkSize);
+            if (begin >= batchSize) break;
+            size_t count = min(chunkSize, batchSize - begin);
+            checker.validateBatch(batchInputs + begin, count, batchResults + begin);
+        }
+    }
+
+    void workerLoop() {
+        ParenthesesChecker checker;
+        unsigned long seen = 0;
+
+        while (true) {
+            {
+                unique_lock<mutex> lock(mtx);
+                workReady.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+
+            runChunks(checker);
+
+            lock_guard<mutex> lock(mtx);
+            if (--activeWorkers == 0) workDone.notify_one();
+        }
+    }
+
+public:
+    // threadCount = 0 picks one worker per hardware thread
+    explicit BatchValidator(unsigned int threadCount = 0, size_t chunk = 4096)
+        : batchInputs(nullptr), batchResults(nullptr), batchSize(0),
+          chunkSize(chunk > 0 ? chunk : 1), nextChunk(0),
+          generation(0), activeWorkers(0), stopping(false) {
+        if (threadCount == 0) {
+            threadCount = thread::hardware_concurrency();
+            if (threadCount == 0) threadCount = 1;
+        }
+        // A single thread gains nothing from a pool; validate inline instead
+        if (threadCount > 1) {
+            for (unsigned int i = 0; i < threadCount; i++) {
+                workers.push_back(thread(&BatchValidator::workerLoop, this));
+            }
+        }
+    }
+
+    ~BatchValidator() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        workReady.notify_all();
+        for (size_t i = 0; i < workers.size(); i++) {
+            workers[i].join();
+        }
+    }
+
+    size_t threadCount() const {
+        return workers.empty() ? 1 : workers.size();
+    }
+
+    // Blocks until inputs[0..count) are validated into results[0..count).
+    // Safe to call from several threads; batches run one after another.
+    void validateBatch(const string* inputs, size_t count, ValidationResult* results) {
+        // Waiting on workDone releases mtx, so mtx alone would let a second
+        // caller overwrite the batch fields mid-batch
+        lock_guard<mutex> submitting(submitMutex);
+        if (workers.empty() || count <= chunkSize) {
+            inlineChecker.validateBatch(inputs, count, results);
+            return;
+        }
+
+        unique_lock<mutex> lock(mtx);
+        batchInputs = inputs;
+        batchResults = results;
+        batchSize = count;
+        nextChunk = 0;
+        activeWorkers = workers.size();
+        generation++;
+        workReady.notify_all();
+        workDone.wait(lock, [&] { return activeWorkers == 0; });
+    }
+
+    vector<ValidationResult> validateBatch(const vector<string>& inputs) {
+        vector<ValidationResult> results(inputs.size());
+        if (!inputs.empty()) {
+            validateBatch(&inputs[0], inputs.size(), &results[0]);
+        }
+        return results;
+    }
+
+private:
+    BatchValidator(const BatchValidator&);
+    BatchValidator& operator=(const BatchValidator&);
+};
+
+void runBatchBenchmark() {
+    const size_t COUNT = 1000000;
+    const string samples[] = {
+        "{[()]}", "((a+b)*(c-d))", "{[(])}", "(()", "())", "<div>{content[0]}</div>"
+    };
+    const size_t SAMPLE_COUNT = sizeof(samples) / sizeof(samples[0]);
+
+    cout << "\n⏱️  Validating " << COUNT << " expressions..." << endl;
+    vector<string> inputs(COUNT);
+    for (size_t i = 0; i < COUNT; i++) {
+        inputs[i] = samples[i % SAMPLE_COUNT];
+    }
+
+    vector<ValidationResult> results(COUNT);
+
+    ParenthesesChecker checker;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    checker.validateBatch(&inputs[0], COUNT, &results[0]);
+    chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+
+    BatchValidator pool;
+    chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+    pool.validateBatch(&inputs[0], COUNT, &results[0]);
+    chrono::steady_clock::time_point t3 = chrono::steady_clock::now();
+
+    size_t balanced = 0;
+    for (size_t i = 0; i < COUNT; i++) {
+        if (results[i].status == BALANCED) balanced++;
+    }
+
+    cout << "  Balanced: " << balanced << ", Invalid: " << (COUNT - balanced) << endl;
+    cout << "  Single thread: "
+         << chrono::duration_cast<chrono::milliseconds>(t1 - t0).count() << " ms" << endl;
+    cout << "  Thread pool (" << pool.threadCount() << " threads): "
+         << chrono::duration_cast<chrono::milliseconds>(t3 - t2).count() << " ms" << endl;
+}
+
 int main() {
     ParenthesesChecker checker;
     checker.displayMenu();
@@ -129,7 +371,8 @@ int main() {
     while (true) {
         cout << "\n  1. Validate Expression\n";
         cout << "  2. Run Test Cases\n";
-        cout << "  3. Exit\n";
+        cout << "  3. Batch Validation Benchmark\n";
+        cout << "  4. Exit\n";
         cout << "  Choice: ";
         cin >> choice;
         cin.ignore();
@@ -144,6 +387,9 @@ int main() {
             checker.runTests();
         }
         else if (choice == 3) {
+            runBatchBenchmark();
+        }
+        else if (choice == 4) {
             cout << "\n  Goodbye!\n";
             break;
         }
@@ -0,0 +1,348 @@
+/*
+ * ============================================================================
+ * EDIT HISTORY - DELTA-BASED UNDO/REDO
+ * ============================================================================
+ * Instead of snapshotting the whole document before every edit, each edit
+ * is recorded as a delta: "at `offset`, `removed` was replaced by
+ * `inserted`". Undo and redo re-apply a delta in O(delta) and the memory
+ * used is proportional to the amount of text changed.
+ *
+ * A replace-all is one delta carrying the list of match offsets, so its
+ * undo entry costs one word per match rather than a copy of the document.
+ *
+ * A paste refers to the clipboard's shared piece list instead of holding
+ * its text, so pasting a huge selection adds almost nothing to history.
+ * Likewise a deletion keeps the removed span as pieces of the immutable
+ * buffers, so clearing a huge memory-mapped file copies no text and its
+ * undo puts the same pieces back.
+ *
+ * Consecutive keystrokes (single-character inserts or backspaces at
+ * adjacent positions) are coalesced into one delta, so undo removes a
+ * typed run at once rather than one character at a time.
+ *
+ * History is held within a memory budget: when the deltas in RAM exceed
+ * it, the oldest entries have their text spilled to a temporary file and
+ * are read back lazily only when undo/redo reaches them.
+ * ============================================================================
+ */
+
+#ifndef EDIT_HISTORY_H
+#define EDIT_HISTORY_H
+
+#include "PieceTable.h"
+#include <deque>
+#include <memory>
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstddef>
+#include <cstdio>
+using namespace std;
+
+struct EditDelta {
+    size_t offset;
+    string removed;
+    string inserted;
+    // Replace-all only: every offset (ascending, before the edit) where
+    // `removed` was replaced by `inserted`; empty for a single edit
+    vector<size_t> offsets;
+    // Paste only: the inserted text as shared pieces (then `inserted` is empty)
+    shared_ptr<const PieceList> insertedPieces;
+    // Multi-character delete only: the removed text as pieces (then
+    // `removed` is empty)
+    shared_ptr<const PieceList> removedPieces;
+
+    EditDelta() : offset(0) {}
+
+    EditDelta(size_t at, const string& oldText, const string& newText)
+        : offset(at), removed(oldText), inserted(newText) {}
+
+    EditDelta(size_t at, const string& oldText, const shared_ptr<const PieceList>& newPieces)
+        : offset(at), removed(oldText), insertedPieces(newPieces) {}
+
+    EditDelta(size_t at, const shared_ptr<const PieceList>& oldPieces, const string& newText)
+        : offset(at), inserted(newText), removedPieces(oldPieces) {}
+
+    size_t insertedLength() const {
+        return insertedPieces ? lengthOf(*insertedPieces) : inserted.size();
+    }
+
+    size_t removedLength() const {
+        return removedPieces ? lengthOf(*removedPieces) : removed.size();
+    }
+
+    // Bytes of text that can be spilled to disk
+    size_t textBytes() const {
+        return removed.size() + inserted.size() + offsets.size() * sizeof(size_t);
+    }
+
+    // Piece references always stay in memory
+    size_t pieceBytes() const {
+        return ((insertedPieces ? insertedPieces->size() : 0) +
+                (removedPieces ? removedPieces->size() : 0)) * sizeof(Piece);
+    }
+};
+
+// A delta on one of the history stacks; when spilled, its text lives in
+// the spill file and only the lengths stay in memory
+struct HistoryEntry {
+    EditDelta delta;
+    bool spilled;
+    long fileOffset;
+    size_t removedLength;
+    size_t insertedLength;
+    size_t offsetCount;
+
+    size_t fullBytes() const {
+        return removedLength + insertedLength + offsetCount * sizeof(size_t);
+    }
+
+    size_t memoryBytes() const {
+        size_t fixed = sizeof(HistoryEntry) + delta.pieceBytes();
+        return spilled ? fixed : fixed + delta.textBytes();
+    }
+
+    size_t diskBytes() const {
+        return spilled ? fullBytes() : 0;
+    }
+};
+
+class EditHistory {
+private:
+    // Both stacks keep their top at the back; the front holds the oldest
+    // entries, which are the first to be spilled
+    deque<HistoryEntry> undoStack;
+    deque<HistoryEntry> redoStack;
+    size_t memoryUsed;
+    size_t diskUsed;
+    size_t memoryBudget;
+    bool typingOpen; // Top of undoStack may absorb the next keystroke
+
+    FILE* spillFile;
+    long spillEnd;      // Append position in the spill file
+    size_t spilledCount;
+    size_t spillScan[2]; // Per stack: entries below this index are spilled
+
+    static HistoryEntry makeEntry(const EditDelta& delta) {
+        HistoryEntry entry;
+        entry.delta = delta;
+        entry.spilled = false;
+        entry.fileOffset = 0;
+        entry.removedLength = delta.removed.size();
+        entry.insertedLength = delta.inserted.size();
+        entry.offsetCount = delta.offsets.size();
+        return entry;
+    }
+
+    void push(deque<HistoryEntry>& s, HistoryEntry&& entry) {
+        memoryUsed += entry.memoryBytes();
+        diskUsed += entry.diskBytes();
+        s.push_back(move(entry));
+    }
+
+    // Discards the top of a stack
+    void drop(deque<HistoryEntry>& s, size_t& scan) {
+        HistoryEntry& entry = s.back();
+        memoryUsed -= entry.memoryBytes();
+        diskUsed -= entry.diskBytes();
+        if (entry.spilled && --spilledCount == 0) {
+            spillEnd = 0; // Nothing on disk is live any more; reuse the file
+        }
+        s.pop_back();
+        if (scan > s.size()) scan = s.size();
+    }
+
+    // Moves the top of one stack onto the other (no accounting changes)
+    void transfer(deque<HistoryEntry>& from, size_t& fromScan, deque<HistoryEntry>& to) {
+        to.push_back(move(from.back()));
+        from.pop_back();
+        if (fromScan > from.size()) fromScan = from.size();
+    }
+
+    bool spill(HistoryEntry& entry) {
+        if (spillFile == nullptr) {
+            spillFile = tmpfile();
+            if (spillFile == nullptr) return false;
+        }
+
+        if (fseek(spillFile, spillEnd, SEEK_SET) != 0) return false;
+        const string& removed = entry.delta.removed;
+        const string& inserted = entry.delta.inserted;
+        const vector<size_t>& offsets = entry.delta.offsets;
+        if (fwrite(removed.data(), 1, removed.size(), spillFile) != removed.size() ||
+            fwrite(inserted.data(), 1, inserted.size(), spillFile) != inserted.size() ||
+            (!offsets.empty() &&
+             fwrite(&offsets[0], sizeof(size_t), offsets.size(), spillFile) != offsets.size())) {
+            return false;
+        }
+
+        memoryUsed -= entry.memoryBytes();
+        entry.fileOffset = spillEnd;
+        entry.spilled = true;
+        string().swap(entry.delta.removed);
+        string().swap(entry.delta.inserted);
+        vector<size_t>().swap(entry.delta.offsets);
+        memoryUsed += entry.memoryBytes();
+        diskUsed += entry.diskBytes();
+
+        spillEnd += (long)entry.fullBytes();
+        spilledCount++;
+        return true;
+    }
+
+    // Reads a spilled entry's text back into memory. On a failed seek or
+    // short read the entry stays spilled and false is returned.
+    bool reload(HistoryEntry& entry) {
+        if (!entry.spilled) return true;
+
+        string removed(entry.removedLength, '\0');
+        string inserted(entry.insertedLength, '\0');
+        vector<size_t> offsets(entry.offsetCount, 0);
+        if (fseek(spillFile, entry.fileOffset, SEEK_SET) != 0 ||
+            (entry.removedLength > 0 &&
+             fread(&removed[0], 1, entry.removedLength, spillFile) != entry.removedLength) ||
+            (entry.insertedLength > 0 &&
+             fread(&inserted[0], 1, entry.insertedLength, spillFile) != entry.insertedLength) ||
+            (entry.offsetCount > 0 &&
+             fread(&offsets[0], sizeof(size_t), entry.offsetCount, spillFile) != entry.offsetCount)) {
+            clearerr(spillFile);
+            return false;
+        }
+
+        diskUsed -= entry.diskBytes();
+        memoryUsed -= entry.memoryBytes();
+        entry.delta.removed.swap(removed);
+        entry.delta.inserted.swap(inserted);
+        entry.delta.offsets.swap(offsets);
+        entry.spilled = false;
+        memoryUsed += entry.memoryBytes();
+
+        if (--spilledCount == 0) spillEnd = 0;
+        return true;
+    }
+
+    // Spills the oldest in-memory entries until history fits the budget.
+    // The top of each stack is never spilled.
+    void enforceBudget() {
+        deque<HistoryEntry>* stacks[2] = {&undoStack, &redoStack};
+        for (int s = 0; s < 2 && memoryUsed > memoryBudget; s++) {
+            deque<HistoryEntry>& entries = *stacks[s];
+            size_t& i = spillScan[s];
+            for (; i + 1 < entries.size() && memoryUsed > memoryBudget; i++) {
+                HistoryEntry& entry = entries[i];
+                if (!entry.spilled && entry.fullBytes() > 0) {
+                    if (!spill(entry)) return;
+                }
+            }
+        }
+    }
+
+    // Tries to fold a keystroke into the delta on top of the undo stack
+    bool coalesce(const EditDelta& delta) {
+        if (!typingOpen || undoStack.empty() || undoStack.back().spilled) return false;
+        HistoryEntry& top = undoStack.back();
+        if (!top.delta.offsets.empty() || !delta.offsets.empty() ||
+            top.delta.insertedPieces || delta.insertedPieces ||
+            top.delta.removedPieces || delta.removedPieces) return false;
+
+        // Typing forward: "ab" + "c" at the end of the run
+        if (delta.removed.empty() && top.delta.removed.empty() &&
+            top.delta.offset + top.delta.inserted.size() == delta.offset) {
+            top.delta.inserted += delta.inserted;
+        }
+        // Backspacing: the deleted character sits just before the run
+        else if (delta.inserted.empty() && top.delta.inserted.empty() &&
+                 delta.offset + delta.removed.size() == top.delta.offset) {
+            top.delta.removed.insert(0, delta.removed);
+            top.delta.offset = delta.offset;
+        }
+        else {
+            return false;
+        }
+
+        memoryUsed += delta.removed.size() + delta.inserted.size();
+        top.removedLength = top.delta.removed.size();
+        top.insertedLength = top.delta.inserted.size();
+        return true;
+    }
+
+    // Not copyable: owns the spill file
+    EditHistory(const EditHistory&);
+    EditHistory& operator=(const EditHistory&);
+
+public:
+    static const size_t DEFAULT_MEMORY_BUDGET = 16 * 1024 * 1024;
+
+    explicit EditHistory(size_t budget = DEFAULT_MEMORY_BUDGET)
+        : memoryUsed(0), diskUsed(0), memoryBudget(budget), typingOpen(false),
+          spillFile(nullptr), spillEnd(0), spilledCount(0) {
+        spillScan[0] = spillScan[1] = 0;
+    }
+
+    ~EditHistory() {
+        if (spillFile != nullptr) fclose(spillFile);
+    }
+
+    // Records a new edit. `keystroke` marks single-character typing that may
+    // be merged with the previous keystroke.
+    void record(const EditDelta& delta, bool keystroke) {
+        while (!redoStack.empty()) drop(redoStack, spillScan[1]);
+
+        if (!(keystroke && coalesce(delta))) {
+            push(undoStack, makeEntry(delta));
+        }
+
+        // A newline ends the current typing run
+        typingOpen = keystroke && delta.inserted != "\n";
+        enforceBudget();
+    }
+
+    // Forgets all history (e.g. when another document is opened)
+    void clear() {
+        while (!undoStack.empty()) drop(undoStack, spillScan[0]);
+        while (!redoStack.empty()) drop(redoStack, spillScan[1]);
+        typingOpen = false;
+    }
+
+    // Ends the current typing run (e.g. after the cursor moves)
+    void seal() {
+        typingOpen = false;
+    }
+
+    bool canUndo() const { return !undoStack.empty(); }
+    bool canRedo() const { return !redoStack.empty(); }
+
+    // Moves the newest delta to the redo stack and returns it; the caller
+    // reverts it on the document. Returns nullptr, leaving both stacks as
+    // they were, if the delta's text cannot be read back from disk.
+    const EditDelta* undo() {
+        typingOpen = false;
+        if (!reload(undoStack.back())) return nullptr;
+        transfer(undoStack, spillScan[0], redoStack);
+        enforceBudget();
+        return &redoStack.back().delta;
+    }
+
+    // Moves the newest undone delta back to the undo stack and returns it;
+    // the caller re-applies it on the document. nullptr as for undo().
+    const EditDelta* redo() {
+        typingOpen = false;
+        if (!reload(redoStack.back())) return nullptr;
+        transfer(redoStack, spillScan[1], undoStack);
+        enforceBudget();
+        return &undoStack.back().delta;
+    }
+
+    void setMemoryBudget(size_t budget) {
+        memoryBudget = budget;
+        enforceBudget();
+    }
+
+    size_t getMemoryBudget() const { return memoryBudget; }
+    size_t undoSize() const { return undoStack.size(); }
+    size_t redoSize() const { return redoStack.size(); }
+    size_t memoryBytes() const { return memoryUsed; }
+    size_t diskBytes() const { return diskUsed; }
+};
+
+#endif
@@ -0,0 +1,745 @@
+/*
+ * ============================================================================
+ * PIECE TABLE - TEXT STORAGE FOR THE EDITOR
+ * ============================================================================
+ * The document is a sequence of "pieces", each pointing at a span of one of
+ * two buffers:
+ *   - ORIGINAL buffer: the text the document was loaded with (never changes);
+ *                      for files this is a read-only memory mapping
+ *   - ADD buffer:      every inserted character, appended in order
+ * Editing never moves existing text; it only splits and rearranges pieces.
+ *
+ * Pieces are kept in an implicit treap (randomized balanced BST keyed by
+ * position) where each node stores the total length of its subtree, so
+ * locating, inserting or deleting at any offset costs O(log P) for P pieces,
+ * independent of the document size in bytes. Typing at the end of the most
+ * recent insertion just extends that piece and allocates nothing.
+ *
+ * Each node also carries the newline/space counts of its subtree, so the
+ * line and word statistics of the document are read from the root in O(1)
+ * and "go to line N" descends the tree in O(log P). Counts for a span of a
+ * buffer come from a per-buffer block index (cumulative counts every 4 KB).
+ *
+ * Because both buffers are immutable (ADD only grows), a range of text can
+ * be copied as a list of pieces and pasted back by reference: no
+ * characters are copied, however large the range.
+ * ============================================================================
+ */
+
+#ifndef PIECE_TABLE_H
+#define PIECE_TABLE_H
+
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cstddef>
+using namespace std;
+
+enum PieceSource {
+    ORIGINAL_BUFFER = 0,
+    ADD_BUFFER = 1
+};
+
+struct Piece {
+    PieceSource source;
+    size_t start;   // Offset into the source buffer
+    size_t length;
+};
+
+typedef vector<Piece> PieceList;
+
+inline size_t lengthOf(const PieceList& pieces) {
+    size_t total = 0;
+    for (size_t i = 0; i < pieces.size(); i++) total += pieces[i].length;
+    return total;
+}
+
+struct TextCounts {
+    size_t newlines;
+    size_t spaces;
+
+    TextCounts() : newlines(0), spaces(0) {}
+    TextCounts(size_t n, size_t s) : newlines(n), spaces(s) {}
+
+    TextCounts operator+(const TextCounts& other) const {
+        return TextCounts(newlines + other.newlines, spaces + other.spaces);
+    }
+
+    TextCounts operator-(const TextCounts& other) const {
+        return TextCounts(newlines - other.newlines, spaces - other.spaces);
+    }
+
+    static TextCounts of(const char* data, size_t length) {
+        TextCounts counts;
+        for (size_t i = 0; i < length; i++) {
+            if (data[i] == '\n') counts.newlines++;
+            else if (data[i] == ' ') counts.spaces++;
+        }
+        return counts;
+    }
+};
+
+// Cumulative counts at every BLOCK_SIZE bytes of a buffer. Counting any
+// span costs two lookups plus a scan of at most two partial blocks.
+class BufferIndex {
+private:
+    vector<TextCounts> blockPrefix; // blockPrefix[b] = counts of data[0, b * BLOCK_SIZE)
+
+public:
+    static const size_t BLOCK_SIZE = 4096;
+
+    BufferIndex() {
+        clear();
+    }
+
+    void clear() {
+        blockPrefix.assign(1, TextCounts());
+    }
+
+    // Indexes every complete block of data[0, length); buffers only grow,
+    // so this picks up where the previous call stopped
+    void extend(const char* data, size_t length) {
+        size_t blocks = length / BLOCK_SIZE;
+        while (blockPrefix.size() <= blocks) {
+            size_t b = blockPrefix.size() - 1;
+            blockPrefix.push_back(blockPrefix.back() + TextCounts::of(data + b * BLOCK_SIZE, BLOCK_SIZE));
+        }
+    }
+
+    // Counts of data[0, offset)
+    TextCounts countBefore(const char* data, size_t offset) const {
+        size_t b = min(offset / BLOCK_SIZE, blockPrefix.size() - 1);
+        return blockPrefix[b] + TextCounts::of(data + b * BLOCK_SIZE, offset - b * BLOCK_SIZE);
+    }
+
+    // Scans whichever is shorter: the span itself or the two partial blocks
+    TextCounts countRange(const char* data, size_t start, size_t length) const {
+        size_t end = start + length;
+        if (length <= start % BLOCK_SIZE + end % BLOCK_SIZE) {
+            return TextCounts::of(data + start, length);
+        }
+        return countBefore(data, end) - countBefore(data, start);
+    }
+
+    // Offset of the n-th newline (1-based) in data[0, length), or length
+    size_t findNewline(const char* data, size_t length, size_t n) const {
+        // Last block that starts with fewer than n newlines before it
+        size_t lo = 0, hi = blockPrefix.size() - 1;
+        while (lo < hi) {
+            size_t mid = (lo + hi + 1) / 2;
+            if (blockPrefix[mid].newlines < n) lo = mid;
+            else hi = mid - 1;
+        }
+
+        size_t seen = blockPrefix[lo].newlines;
+        for (size_t i = lo * BLOCK_SIZE; i < length; i++) {
+            if (data[i] == '\n' && ++seen == n) return i;
+        }
+        return length;
+    }
+};
+
+class PieceTable {
+private:
+    struct Node {
+        Piece piece;
+        TextCounts pieceCounts;
+        unsigned int priority;
+        size_t subtreeLength;    // Total characters in this subtree
+        TextCounts subtreeCounts; // Total newlines/spaces in this subtree
+        Node* left;
+        Node* right;
+
+        Node(const Piece& p, const TextCounts& counts, unsigned int prio)
+            : piece(p), pieceCounts(counts), priority(prio), subtreeLength(p.length),
+              subtreeCounts(counts), left(nullptr), right(nullptr) {}
+    };
+
+    Node* root;
+    size_t pieceCount;
+    const char* originalData; // Either originalText or the mapped file
+    size_t originalLength;
+    string originalText;
+    MappedFile mappedFile;
+    string added;
+    BufferIndex addedIndex;
+    // The ORIGINAL buffer is indexed lazily, on the first statistics query,
+    // so that opening a huge file stays O(1). Until then its pieces count 0.
+    mutable BufferIndex originalIndex;
+    mutable bool originalIndexed;
+    unsigned int seed; // xorshift state for node priorities
+
+    unsigned int nextPriority() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+
+    static size_t sizeOf(Node* node) {
+        return node ? node->subtreeLength : 0;
+    }
+
+    static TextCounts countsOf(Node* node) {
+        return node ? node->subtreeCounts : TextCounts();
+    }
+
+    static void update(Node* node) {
+        node->subtreeLength = sizeOf(node->left) + node->piece.length + sizeOf(node->right);
+        node->subtreeCounts = countsOf(node->left) + node->pieceCounts + countsOf(node->right);
+    }
+
+    const char* sourceData(PieceSource source) const {
+        return source == ORIGINAL_BUFFER ? originalData : added.data();
+    }
+
+    size_t sourceLength(PieceSource source) const {
+        return source == ORIGINAL_BUFFER ? originalLength : added.size();
+    }
+
+    const BufferIndex& indexOf(PieceSource source) const {
+        return source == ORIGINAL_BUFFER ? originalIndex : addedIndex;
+    }
+
+    TextCounts countPiece(const Piece& piece) const {
+        if (piece.source == ORIGINAL_BUFFER && !originalIndexed) return TextCounts();
+        return indexOf(piece.source).countRange(sourceData(piece.source), piece.start, piece.length);
+    }
+
+    Node* createNode(const Piece& piece, const TextCounts& counts) {
+        pieceCount++;
+        return new Node(piece, counts, nextPriority());
+    }
+
+    Node* createNode(const Piece& piece) {
+        return createNode(piece, countPiece(piece));
+    }
+
+    // Recomputes the counts of ORIGINAL pieces once the buffer is indexed
+    void recount(Node* node) const {
+        if (node == nullptr) return;
+        recount(node->left);
+        recount(node->right);
+        if (node->piece.source == ORIGINAL_BUFFER) node->pieceCounts = countPiece(node->piece);
+        update(node);
+    }
+
+    void ensureIndexed() const {
+        if (originalIndexed) return;
+        originalIndex.extend(originalData, originalLength);
+        originalIndexed = true;
+        recount(root);
+    }
+
+    // Document offset of the n-th newline (1-based) within a subtree
+    size_t findNewline(Node* node, size_t n) const {
+        size_t leftNewlines = countsOf(node->left).newlines;
+        if (n <= leftNewlines) return findNewline(node->left, n);
+
+        n -= leftNewlines;
+        size_t base = sizeOf(node->left);
+        const Piece& piece = node->piece;
+        if (n <= node->pieceCounts.newlines) {
+            const char* data = sourceData(piece.source);
+            const BufferIndex& index = indexOf(piece.source);
+            size_t before = index.countBefore(data, piece.start).newlines;
+            return base + index.findNewline(data, sourceLength(piece.source), before + n) - piece.start;
+        }
+
+        n -= node->pieceCounts.newlines;
+        return base + piece.length + findNewline(node->right, n);
+    }
+
+    void destroy(Node* node) {
+        if (node == nullptr) return;
+        destroy(node->left);
+        destroy(node->right);
+        delete node;
+        pieceCount--;
+    }
+
+    Node* merge(Node* a, Node* b) {
+        if (a == nullptr) return b;
+        if (b == nullptr) return a;
+
+        if (a->priority > b->priority) {
+            a->right = merge(a->right, b);
+            update(a);
+            return a;
+        }
+        b->left = merge(a, b->left);
+        update(b);
+        return b;
+    }
+
+    // Splits the tree into [0, offset) and [offset, end), cutting a piece in
+    // two when the offset falls inside it
+    void split(Node* node, size_t offset, Node*& leftPart, Node*& rightPart) {
+        if (node == nullptr) {
+            leftPart = rightPart = nullptr;
+            return;
+        }
+
+        size_t leftLength = sizeOf(node->left);
+        size_t pieceEnd = leftLength + node->piece.length;
+
+        if (offset <= leftLength) {
+            split(node->left, offset, leftPart, node->left);
+            update(node);
+            rightPart = node;
+        }
+        else if (offset >= pieceEnd) {
+            split(node->right, offset - pieceEnd, node->right, rightPart);
+            update(node);
+            leftPart = node;
+        }
+        else {
+            size_t head = offset - leftLength;
+            Piece tail = {node->piece.source, node->piece.start + head, node->piece.length - head};
+            node->piece.length = head;
+            TextCounts headCounts = countPiece(node->piece);
+            TextCounts tailCounts = node->pieceCounts - headCounts;
+            node->pieceCounts = headCounts;
+
+            Node* after = node->right;
+            node->right = nullptr;
+            update(node);
+            leftPart = node;
+            rightPart = merge(createNode(tail, tailCounts), after);
+        }
+    }
+
+    // Grows the ADD piece that ends exactly at `offset` if it is also the
+    // tail of the ADD buffer (i.e. the user is still typing in one place)
+    bool tryExtend(Node* node, size_t offset, size_t count, const TextCounts& counts) {
+        if (node == nullptr) return false;
+
+        size_t leftLength = sizeOf(node->left);
+        size_t pieceEnd = leftLength + node->piece.length;
+        bool extended = false;
+
+        if (offset <= leftLength) {
+            extended = tryExtend(node->left, offset, count, counts);
+        }
+        else if (offset > pieceEnd) {
+            extended = tryExtend(node->right, offset - pieceEnd, count, counts);
+        }
+        else if (offset == pieceEnd &&
+                 node->piece.source == ADD_BUFFER &&
+                 node->piece.start + node->piece.length + count == added.size()) {
+            node->piece.length += count;
+            node->pieceCounts = node->pieceCounts + counts;
+            extended = true;
+        }
+
+        if (extended) {
+            node->subtreeLength += count;
+            node->subtreeCounts = node->subtreeCounts + counts;
+        }
+        return extended;
+    }
+
+    void appendRange(Node* node, size_t offset, size_t count, string& out) const {
+        if (node == nullptr || count == 0) return;
+
+        size_t leftLength = sizeOf(node->left);
+        size_t pieceEnd = leftLength + node->piece.length;
+
+        if (offset < leftLength) {
+            appendRange(node->left, offset, count, out);
+        }
+        if (offset < pieceEnd && offset + count > leftLength) {
+            size_t from = offset > leftLength ? offset - leftLength : 0;
+            size_t to = min(node->piece.length, offset + count - leftLength);
+            out.append(sourceData(node->piece.source) + node->piece.start + from, to - from);
+        }
+        if (offset + count > pieceEnd) {
+            size_t skip = offset > pieceEnd ? offset - pieceEnd : 0;
+            size_t consumed = pieceEnd > offset ? pieceEnd - offset : 0;
+            appendRange(node->right, skip, count - consumed, out);
+        }
+    }
+
+    void collectRange(Node* node, size_t offset, size_t count, PieceList& out) const {
+        if (node == nullptr || count == 0) return;
+
+        size_t leftLength = sizeOf(node->left);
+        size_t pieceEnd = leftLength + node->piece.length;
+
+        if (offset < leftLength) {
+            collectRange(node->left, offset, count, out);
+        }
+        if (offset < pieceEnd && offset + count > leftLength) {
+            size_t from = offset > leftLength ? offset - leftLength : 0;
+            size_t to = min(node->piece.length, offset + count - leftLength);
+            Piece part = {node->piece.source, node->piece.start + from, to - from};
+            out.push_back(part);
+        }
+        if (offset + count > pieceEnd) {
+            size_t skip = offset > pieceEnd ? offset - pieceEnd : 0;
+            size_t consumed = pieceEnd > offset ? pieceEnd - offset : 0;
+            collectRange(node->right, skip, count - consumed, out);
+        }
+    }
+
+    template <typename Visitor>
+    void visit(Node* node, Visitor& visitor) const {
+        if (node == nullptr) return;
+        visit(node->left, visitor);
+        visitor(sourceData(node->piece.source) + node->piece.start, node->piece.length);
+        visit(node->right, visitor);
+    }
+
+    // Stops early (returns false) when the visitor returns false
+    template <typename Visitor>
+    bool visitFrom(Node* node, size_t offset, size_t base, Visitor& visitor) const {
+        if (node == nullptr) return true;
+
+        size_t leftLength = sizeOf(node->left);
+        size_t pieceEnd = leftLength + node->piece.length;
+
+        if (offset < leftLength && !visitFrom(node->left, offset, base, visitor)) return false;
+        if (offset < pieceEnd) {
+            size_t skip = offset > leftLength ? offset - leftLength : 0;
+            const char* data = sourceData(node->piece.source) + node->piece.start;
+            if (!visitor(data + skip, node->piece.length - skip, base + leftLength + skip)) return false;
+        }
+        return visitFrom(node->right, offset > pieceEnd ? offset - pieceEnd : 0, base + pieceEnd, visitor);
+    }
+
+    struct PieceInfo {
+        Piece piece;
+        TextCounts counts;
+    };
+
+    void collect(Node* node, vector<PieceInfo>& out) const {
+        if (node == nullptr) return;
+        collect(node->left, out);
+        PieceInfo info = {node->piece, node->pieceCounts};
+        out.push_back(info);
+        collect(node->right, out);
+    }
+
+    static void updateAll(Node* node) {
+        if (node == nullptr) return;
+        updateAll(node->left);
+        updateAll(node->right);
+        update(node);
+    }
+
+    // Builds a treap from nodes already in document order in O(n), using
+    // the stack-based Cartesian tree construction
+    static Node* buildTree(const vector<Node*>& nodes) {
+        vector<Node*> spine; // Right spine of the tree built so far
+        for (size_t i = 0; i < nodes.size(); i++) {
+            Node* node = nodes[i];
+            Node* last = nullptr;
+            while (!spine.empty() && spine.back()->priority < node->priority) {
+                last = spine.back();
+                spine.pop_back();
+            }
+            node->left = last;
+            node->right = nullptr;
+            if (!spine.empty()) spine.back()->right = node;
+            spine.push_back(node);
+        }
+
+        Node* top = spine.empty() ? nullptr : spine.front();
+        updateAll(top);
+        return top;
+    }
+
+    void reset() {
+        destroy(root);
+        root = nullptr;
+        mappedFile.close();
+        string().swap(originalText);
+        originalData = nullptr;
+        originalLength = 0;
+        originalIndex.clear();
+        originalIndexed = false;
+        added.clear();
+        addedIndex.clear();
+    }
+
+    void addOriginalPiece() {
+        if (originalLength > 0) {
+            Piece piece = {ORIGINAL_BUFFER, 0, originalLength};
+            root = createNode(piece);
+        }
+    }
+
+    // Not copyable: nodes are owned by this table
+    PieceTable(const PieceTable&);
+    PieceTable& operator=(const PieceTable&);
+
+public:
+    PieceTable()
+        : root(nullptr), pieceCount(0), originalData(nullptr), originalLength(0),
+          originalIndexed(false), seed(2463534242u) {}
+
+    ~PieceTable() {
+        destroy(root);
+    }
+
+    size_t length() const {
+        return sizeOf(root);
+    }
+
+    bool empty() const {
+        return root == nullptr;
+    }
+
+    size_t pieces() const {
+        return pieceCount;
+    }
+
+    // Number of lines (0 for an empty document)
+    size_t lineCount() const {
+        if (empty()) return 0;
+        ensureIndexed();
+        return root->subtreeCounts.newlines + 1;
+    }
+
+    // Words as counted by the editor: one more than the separators
+    // (spaces and newlines) in the text
+    size_t wordCount() const {
+        if (empty()) return 0;
+        ensureIndexed();
+        return root->subtreeCounts.newlines + root->subtreeCounts.spaces + 1;
+    }
+
+    // Offset of the first character of a line (1-based). Lines past the
+    // end map to the end of the document.
+    size_t lineStart(size_t line) const {
+        if (line <= 1 || empty()) return 0;
+        ensureIndexed();
+        if (line - 1 > root->subtreeCounts.newlines) return length();
+        return findNewline(root, line - 1) + 1;
+    }
+
+    // Replaces the whole document; the text becomes the ORIGINAL buffer
+    void load(const string& text) {
+        reset();
+        originalText = text;
+        originalData = originalText.data();
+        originalLength = originalText.size();
+        addOriginalPiece();
+    }
+
+    // Opens a file as the document in O(1): the file is memory-mapped and
+    // becomes the ORIGINAL buffer, so nothing is read until it is needed
+    bool loadFile(const string& path) {
+        MappedFile file;
+        if (!file.open(path)) return false; // Keep the current document
+
+        reset();
+        mappedFile.swap(file);
+        originalData = mappedFile.begin();
+        originalLength = mappedFile.length();
+        addOriginalPiece();
+        return true;
+    }
+
+    // Streams the pieces to a file without building the whole text. The
+    // data goes to a temporary file that is then renamed over `path`, so
+    // saving over the mapped file being edited is safe.
+    bool saveFile(const string& path) const {
+        string tempPath = path + ".tmp";
+        ofstream out(tempPath.c_str(), ios::binary | ios::trunc);
+        if (!out) return false;
+        forEachPiece([&out](const char* data, size_t length) {
+            out.write(data, length);
+        });
+        out.close();
+        if (!out) {
+            remove(tempPath.c_str());
+            return false;
+        }
+        return replaceFile(tempPath, path);
+    }
+
+    void clear() {
+        destroy(root);
+        root = nullptr;
+    }
+
+    void insert(size_t offset, const char* text, size_t count) {
+        if (count == 0) return;
+        if (offset > length()) offset = length();
+
+        added.append(text, count);
+        addedIndex.extend(added.data(), added.size());
+        if (tryExtend(root, offset, count, TextCounts::of(text, count))) return;
+
+        Piece piece = {ADD_BUFFER, added.size() - count, count};
+        Node* leftPart;
+        Node* rightPart;
+        split(root, offset, leftPart, rightPart);
+        root = merge(merge(leftPart, createNode(piece)), rightPart);
+    }
+
+    void insert(size_t offset, const string& text) {
+        insert(offset, text.data(), text.size());
+    }
+
+    // Pieces covering [offset, offset + count) in O(log P + k); shares the
+    // text instead of copying it. Valid until the next load()/loadFile().
+    PieceList copyRange(size_t offset, size_t count) const {
+        PieceList pieces;
+        if (offset >= length()) return pieces;
+        collectRange(root, offset, min(count, length() - offset), pieces);
+        return pieces;
+    }
+
+    // Inserts pieces obtained from copyRange() of this table, by reference
+    void insertPieces(size_t offset, const PieceList& pieces) {
+        if (pieces.empty()) return;
+        if (offset > length()) offset = length();
+
+        vector<Node*> nodes;
+        nodes.reserve(pieces.size());
+        for (size_t i = 0; i < pieces.size(); i++) {
+            if (pieces[i].length > 0) nodes.push_back(createNode(pieces[i]));
+        }
+
+        Node* leftPart;
+        Node* rightPart;
+        split(root, offset, leftPart, rightPart);
+        root = merge(merge(leftPart, buildTree(nodes)), rightPart);
+    }
+
+    // The characters a piece list refers to
+    string textOf(const PieceList& pieces) const {
+        string out;
+        out.reserve(lengthOf(pieces));
+        for (size_t i = 0; i < pieces.size(); i++) {
+            out.append(sourceData(pieces[i].source) + pieces[i].start, pieces[i].length);
+        }
+        return out;
+    }
+
+    // Stores text in the ADD buffer without placing it in the document, so
+    // it can later be inserted by reference
+    PieceList store(const string& text) {
+        PieceList pieces;
+        if (text.empty()) return pieces;
+        Piece piece = {ADD_BUFFER, added.size(), text.size()};
+        added += text;
+        addedIndex.extend(added.data(), added.size());
+        pieces.push_back(piece);
+        return pieces;
+    }
+
+    void erase(size_t offset, size_t count) {
+        if (offset >= length() || count == 0) return;
+        count = min(count, length() - offset);
+
+        Node* leftPart;
+        Node* middle;
+        Node* rightPart;
+        split(root, offset, leftPart, rightPart);
+        split(rightPart, count, middle, rightPart);
+        destroy(middle);
+        root = merge(leftPart, rightPart);
+    }
+
+    string substr(size_t offset, size_t count) const {
+        string out;
+        if (offset >= length()) return out;
+        count = min(count, length() - offset);
+        out.reserve(count);
+        appendRange(root, offset, count, out);
+        return out;
+    }
+
+    string toString() const {
+        return substr(0, length());
+    }
+
+    // Replaces `removedLength` characters at each offset (ascending and
+    // non-overlapping) with `inserted`, in one linear pass over the pieces.
+    // The inserted text is stored once and shared by every replacement.
+    void replaceAt(const vector<size_t>& offsets, size_t removedLength, const string& inserted) {
+        if (offsets.empty()) return;
+
+        Piece insertedPiece = {ADD_BUFFER, added.size(), inserted.size()};
+        TextCounts insertedCounts = TextCounts::of(inserted.data(), inserted.size());
+        added += inserted;
+        addedIndex.extend(added.data(), added.size());
+
+        vector<PieceInfo> oldPieces;
+        oldPieces.reserve(pieceCount);
+        collect(root, oldPieces);
+        size_t total = length();
+        destroy(root);
+        root = nullptr;
+
+        vector<Node*> nodes;
+        nodes.reserve(oldPieces.size() + 2 * offsets.size());
+        size_t pi = 0;
+        size_t pieceStart = 0; // Document offset of oldPieces[pi]
+
+        // Appends a piece, merging it into the previous one when the two are
+        // contiguous in the same buffer (e.g. when undo restores the text)
+        auto emit = [&](const Piece& piece, const TextCounts& counts) {
+            if (!nodes.empty()) {
+                Node* last = nodes.back();
+                if (last->piece.source == piece.source &&
+                    last->piece.start + last->piece.length == piece.start) {
+                    last->piece.length += piece.length;
+                    last->pieceCounts = last->pieceCounts + counts;
+                    return;
+                }
+            }
+            nodes.push_back(createNode(piece, counts));
+        };
+
+        // Emits the text of the old document in [from, to)
+        auto keep = [&](size_t from, size_t to) {
+            while (from < to) {
+                while (pieceStart + oldPieces[pi].piece.length <= from) {
+                    pieceStart += oldPieces[pi].piece.length;
+                    pi++;
+                }
+                const PieceInfo& info = oldPieces[pi];
+                size_t a = from - pieceStart;
+                size_t b = min(info.piece.length, to - pieceStart);
+                if (a == 0 && b == info.piece.length) {
+                    emit(info.piece, info.counts);
+                } else {
+                    Piece part = {info.piece.source, info.piece.start + a, b - a};
+                    emit(part, countPiece(part));
+                }
+                from = pieceStart + b;
+            }
+        };
+
+        size_t previousEnd = 0;
+        for (size_t i = 0; i < offsets.size(); i++) {
+            keep(previousEnd, offsets[i]);
+            if (!inserted.empty()) emit(insertedPiece, insertedCounts);
+            previousEnd = offsets[i] + removedLength;
+        }
+        keep(previousEnd, total);
+
+        root = buildTree(nodes);
+    }
+
+    // Calls visitor(data, length, documentOffset) for each piece from
+    // `offset` onwards (the first one trimmed) until the visitor returns false
+    template <typename Visitor>
+    void forEachPieceFrom(size_t offset, Visitor visitor) const {
+        visitFrom(root, offset, 0, visitor);
+    }
+
+    // Calls visitor(const char* data, size_t length) for each piece in order
+    template <typename Visitor>
+    void forEachPiece(Visitor visitor) const {
+        visit(root, visitor);
+    }
+};
+
+#endif
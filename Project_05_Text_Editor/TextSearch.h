@@ -0,0 +1,112 @@
+/*
+ * ============================================================================
+ * TEXT SEARCH - BOYER-MOORE-HORSPOOL OVER THE PIECE TABLE
+ * ============================================================================
+ * Horspool compares the last character of the pattern first and, on a
+ * mismatch, skips ahead by a precomputed shift for that character, so most
+ * of the text is never looked at. Single-character patterns go straight
+ * to memchr.
+ *
+ * The document is searched piece by piece without building one string.
+ * A match that straddles a piece boundary is found through a small carry
+ * buffer holding the last (m - 1) characters seen.
+ * ============================================================================
+ */
+
+#ifndef TEXT_SEARCH_H
+#define TEXT_SEARCH_H
+
+#include "PieceTable.h"
+#include <string>
+#include <cstring>
+using namespace std;
+
+class PatternSearcher {
+private:
+    string pattern;
+    size_t shift[256]; // Skip distance keyed by the text char under the pattern end
+
+public:
+    explicit PatternSearcher(const string& p) : pattern(p) {
+        size_t m = pattern.size();
+        for (int c = 0; c < 256; c++) shift[c] = m;
+        for (size_t i = 0; i + 1 < m; i++) {
+            shift[(unsigned char)pattern[i]] = m - 1 - i;
+        }
+    }
+
+    size_t length() const {
+        return pattern.size();
+    }
+
+    const string& text() const {
+        return pattern;
+    }
+
+    // First match starting in data[from, length), or length if none
+    size_t findIn(const char* data, size_t length, size_t from) const {
+        size_t m = pattern.size();
+        if (m == 0 || from >= length || length - from < m) return length;
+
+        if (m == 1) {
+            const void* hit = memchr(data + from, pattern[0], length - from);
+            return hit ? (const char*)hit - data : length;
+        }
+
+        char last = pattern[m - 1];
+        for (size_t i = from; i + m <= length; ) {
+            char c = data[i + m - 1];
+            if (c == last && memcmp(data + i, pattern.data(), m - 1) == 0) return i;
+            i += shift[(unsigned char)c];
+        }
+        return length;
+    }
+};
+
+// Calls onMatch(offset) for every match starting at or after `from`, in
+// document order, until it returns false. Overlapping matches are reported.
+template <typename Callback>
+void searchDocument(const PieceTable& document, const PatternSearcher& searcher, size_t from, Callback onMatch) {
+    size_t m = searcher.length();
+    if (m == 0) return;
+
+    string carry;         // Last (m - 1) characters before the current piece
+    size_t carryStart = from;
+    string window;
+
+    document.forEachPieceFrom(from, [&](const char* data, size_t length, size_t offset) {
+        // Matches that start in the carry and end inside this piece
+        if (!carry.empty()) {
+            window.assign(carry);
+            window.append(data, min(length, m - 1));
+            for (size_t pos = searcher.findIn(window.data(), window.size(), 0);
+                 pos < carry.size();
+                 pos = searcher.findIn(window.data(), window.size(), pos + 1)) {
+                if (!onMatch(carryStart + pos)) return false;
+            }
+        }
+
+        // Matches entirely inside this piece
+        for (size_t pos = searcher.findIn(data, length, 0);
+             pos < length;
+             pos = searcher.findIn(data, length, pos + 1)) {
+            if (!onMatch(offset + pos)) return false;
+        }
+
+        // Keep the last (m - 1) characters for the next boundary
+        if (length >= m - 1) {
+            carry.assign(data + length - (m - 1), m - 1);
+            carryStart = offset + length - (m - 1);
+        } else {
+            carry.append(data, length);
+            if (carry.size() > m - 1) {
+                size_t excess = carry.size() - (m - 1);
+                carry.erase(0, excess);
+                carryStart += excess;
+            }
+        }
+        return true;
+    });
+}
+
+#endif
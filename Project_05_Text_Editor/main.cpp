@@ -2,131 +2,329 @@
  * ============================================================================
  * PROJECT #5: UNDO/REDO TEXT EDITOR
  * ============================================================================
- * Data Structure: Two Stacks (undo stack + redo stack)
- * Features: Insert, delete, undo, redo, clipboard operations
+ * Data Structure: Piece Table (treap of pieces) + Two Stacks of edit deltas
+ * Features: Cursor-based insert/delete, undo, redo, zero-copy clipboard,
+ *           memory-mapped open and streaming save for very large files,
+ *           find and replace-all (Boyer-Moore-Horspool)
  * ============================================================================
  */
 
+#include "PieceTable.h"
+#include "EditHistory.h"
+#include "TextSearch.h"
 #include <iostream>
-#include <stack>
 #include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
 using namespace std;
 
 class TextEditor {
 private:
-    string content;
-    stack<string> undoStack;
-    stack<string> redoStack;
-    string clipboard;
+    PieceTable document;
+    size_t cursor; // Insert/delete position, 0..document.length()
+    EditHistory history;
+    // Copied text as shared, immutable pieces of the document's buffers;
+    // copying and pasting never duplicates the characters themselves
+    shared_ptr<const PieceList> clipboard;
 
-    void saveState() {
-        undoStack.push(content);
-        // Clear redo stack when new action is performed
-        while (!redoStack.empty()) redoStack.pop();
+    // Applies a delta to the document: forwards (edit/redo) replaces
+    // `removed` with `inserted`, backwards (undo) does the opposite
+    void applyDelta(const EditDelta& delta, bool forward) {
+        if (delta.offsets.empty()) {
+            if (forward) {
+                document.erase(delta.offset, delta.removedLength());
+                if (delta.insertedPieces) document.insertPieces(delta.offset, *delta.insertedPieces);
+                else document.insert(delta.offset, delta.inserted);
+                cursor = delta.offset + delta.insertedLength();
+            } else {
+                document.erase(delta.offset, delta.insertedLength());
+                if (delta.removedPieces) document.insertPieces(delta.offset, *delta.removedPieces);
+                else document.insert(delta.offset, delta.removed);
+                cursor = delta.offset + delta.removedLength();
+            }
+            return;
+        }
+
+        const string& from = forward ? delta.removed : delta.inserted;
+        const string& to = forward ? delta.inserted : delta.removed;
+
+        // Replace-all: offsets are recorded before the edit; after it, the
+        // i-th match has moved by i * (inserted - removed)
+        vector<size_t> positions(delta.offsets);
+        if (!forward) {
+            for (size_t i = 0; i < positions.size(); i++) {
+                positions[i] = positions[i] + i * delta.inserted.size() - i * delta.removed.size();
+            }
+        }
+        document.replaceAt(positions, from.size(), to);
+        cursor = positions[0] + to.size();
+    }
+
+    // Applies a new edit and records it for undo
+    void applyEdit(const EditDelta& delta, bool keystroke) {
+        applyDelta(delta, true);
+        history.record(delta, keystroke);
+    }
+
+    // Deletes a span, recording it for undo as pieces of the immutable
+    // buffers rather than a copy of its text
+    void removeRange(size_t offset, size_t count) {
+        shared_ptr<const PieceList> pieces = make_shared<const PieceList>(document.copyRange(offset, count));
+        EditDelta delta(offset, pieces, "");
+        applyEdit(delta, false);
     }
 
 public:
-    TextEditor() : content("") {}
+    TextEditor() : cursor(0) {}
 
     void insertText(const string& text) {
-        saveState();
-        content += text;
+        if (!text.empty()) {
+            EditDelta delta(cursor, "", text);
+            applyEdit(delta, text.length() == 1);
+        }
         cout << "✅ Text inserted." << endl;
     }
 
-    void deleteText(int count) {
-        if (count > content.length()) count = content.length();
-        saveState();
-        content = content.substr(0, content.length() - count);
+    // Deletes up to `count` characters before the cursor (like Backspace)
+    void deleteText(size_t count) {
+        if (count > cursor) count = cursor;
+        if (count == 1) {
+            // A single backspace keeps its character so typing runs coalesce
+            EditDelta delta(cursor - 1, document.substr(cursor - 1, 1), "");
+            applyEdit(delta, true);
+        } else if (count > 1) {
+            removeRange(cursor - count, count);
+        }
         cout << "✅ Deleted " << count << " character(s)." << endl;
     }
 
+    void moveCursor(size_t position) {
+        cursor = min(position, document.length());
+        history.seal();
+        cout << "➡️  Cursor at position " << cursor << "." << endl;
+    }
+
+    // Moves the cursor past the next match at or after the cursor,
+    // wrapping around to the start of the document
+    void find(const string& pattern) {
+        PatternSearcher searcher(pattern);
+        size_t match = document.length();
+        auto first = [&match](size_t offset) {
+            match = offset;
+            return false;
+        };
+
+        searchDocument(document, searcher, cursor, first);
+        if (match == document.length() && cursor > 0) {
+            searchDocument(document, searcher, 0, first);
+        }
+
+        if (pattern.empty() || match == document.length()) {
+            cout << "❌ \"" << pattern << "\" not found!" << endl;
+            return;
+        }
+        cursor = match + pattern.length();
+        history.seal();
+        cout << "🔍 Found at position " << match << "." << endl;
+    }
+
+    // Replaces every non-overlapping match in one pass, recorded as a
+    // single undo step
+    void replaceAll(const string& pattern, const string& replacement) {
+        PatternSearcher searcher(pattern);
+        vector<size_t> matches;
+        size_t nextAllowed = 0;
+        searchDocument(document, searcher, 0, [&](size_t offset) {
+            if (offset >= nextAllowed) {
+                matches.push_back(offset);
+                nextAllowed = offset + pattern.length();
+            }
+            return true;
+        });
+
+        if (matches.empty()) {
+            cout << "❌ \"" << pattern << "\" not found!" << endl;
+            return;
+        }
+
+        EditDelta delta(matches[0], pattern, replacement);
+        delta.offsets = matches;
+        applyEdit(delta, false);
+        cout << "✅ Replaced " << matches.size() << " occurrence(s)." << endl;
+    }
+
+    // Moves the cursor to the start of a line (1-based) in O(log n)
+    void goToLine(size_t line) {
+        cursor = document.lineStart(line);
+        history.seal();
+        cout << "➡️  Cursor at position " << cursor << "." << endl;
+    }
+
+    // Limits the RAM used by undo/redo history; older entries go to disk
+    void setHistoryBudget(size_t bytes) {
+        history.setMemoryBudget(bytes);
+        cout << "✅ History memory budget set to " << bytes << " bytes." << endl;
+    }
+
     void undo() {
-        if (undoStack.empty()) {
+        if (!history.canUndo()) {
             cout << "❌ Nothing to undo!" << endl;
             return;
         }
-        redoStack.push(content);
-        content = undoStack.top();
-        undoStack.pop();
+        const EditDelta* delta = history.undo();
+        if (delta == nullptr) {
+            cout << "❌ Could not read undo history back from disk; nothing changed." << endl;
+            return;
+        }
+        applyDelta(*delta, false);
         cout << "↩️  Undo successful." << endl;
     }
 
     void redo() {
-        if (redoStack.empty()) {
+        if (!history.canRedo()) {
             cout << "❌ Nothing to redo!" << endl;
             return;
         }
-        undoStack.push(content);
-        content = redoStack.top();
-        redoStack.pop();
+        const EditDelta* delta = history.redo();
+        if (delta == nullptr) {
+            cout << "❌ Could not read redo history back from disk; nothing changed." << endl;
+            return;
+        }
+        applyDelta(*delta, true);
         cout << "↪️  Redo successful." << endl;
     }
 
     void copy() {
-        clipboard = content;
+        clipboard = make_shared<const PieceList>(document.copyRange(0, document.length()));
         cout << "📋 Copied to clipboard." << endl;
     }
 
     void paste() {
-        if (clipboard.empty()) {
+        if (!clipboard || clipboard->empty()) {
             cout << "❌ Clipboard is empty!" << endl;
             return;
         }
-        saveState();
-        content += clipboard;
+        EditDelta delta(cursor, "", clipboard);
+        applyEdit(delta, false);
         cout << "📋 Pasted from clipboard." << endl;
     }
 
     void clear() {
-        saveState();
-        content = "";
+        if (!document.empty()) {
+            removeRange(0, document.length());
+        }
         cout << "🗑️  Content cleared." << endl;
     }
 
+    // Opens a file for editing; large files are memory-mapped, not read
+    void openFile(const string& path) {
+        // The clipboard points into the current buffers, which are about to
+        // be released; keep its text and re-store it in the new document
+        string clipText = clipboard ? document.textOf(*clipboard) : "";
+
+        if (!document.loadFile(path)) {
+            cout << "❌ Could not open '" << path << "'!" << endl;
+            return;
+        }
+        if (clipboard) clipboard = make_shared<const PieceList>(document.store(clipText));
+        history.clear();
+        cursor = 0;
+        cout << "📂 Opened '" << path << "' (" << document.length() << " characters)." << endl;
+    }
+
+    void saveFile(const string& path) const {
+        if (!document.saveFile(path)) {
+            cout << "❌ Could not save to '" << path << "'!" << endl;
+            return;
+        }
+        cout << "💾 Saved to '" << path << "'." << endl;
+    }
+
     void display() const {
         cout << "\n" << string(60, '=') << endl;
         cout << "📄 Current Content:" << endl;
         cout << string(60, '-') << endl;
-        if (content.empty()) {
+        if (document.empty()) {
             cout << "(empty)" << endl;
         } else {
-            cout << content << endl;
+            document.forEachPiece([](const char* data, size_t length) {
+                cout.write(data, length);
+            });
+            cout << endl;
         }
         cout << string(60, '=') << endl;
-        cout << "Length: " << content.length() << " characters" << endl;
-        cout << "Undo available: " << (undoStack.empty() ? "No" : "Yes") << endl;
-        cout << "Redo available: " << (redoStack.empty() ? "No" : "Yes") << endl;
+        cout << "Length: " << document.length() << " characters | Lines: " << document.lineCount()
+             << " | Words: " << document.wordCount() << endl;
+        cout << "Cursor: " << cursor << endl;
+        cout << "Undo available: " << (history.canUndo() ? "Yes" : "No") << endl;
+        cout << "Redo available: " << (history.canRedo() ? "Yes" : "No") << endl;
     }
 
     void showStats() const {
         cout << "\n📊 Statistics:" << endl;
-        cout << "  Total characters: " << content.length() << endl;
-        cout << "  Words: " << countWords() << endl;
-        cout << "  Lines: " << countLines() << endl;
-        cout << "  Undo stack size: " << undoStack.size() << endl;
-        cout << "  Redo stack size: " << redoStack.size() << endl;
+        cout << "  Total characters: " << document.length() << endl;
+        cout << "  Words: " << document.wordCount() << endl;
+        cout << "  Lines: " << document.lineCount() << endl;
+        cout << "  Pieces: " << document.pieces() << endl;
+        cout << "  Undo stack size: " << history.undoSize() << endl;
+        cout << "  Redo stack size: " << history.redoSize() << endl;
+        cout << "  History in RAM: " << history.memoryBytes() << " bytes (budget "
+             << history.getMemoryBudget() << ")" << endl;
+        cout << "  History on disk: " << history.diskBytes() << " bytes" << endl;
     }
+};
 
-private:
-    int countWords() const {
-        if (content.empty()) return 0;
-        int count = 1;
-        for (char ch : content) {
-            if (ch == ' ' || ch == '\n') count++;
-        }
-        return count;
+// Compares cursor-local edits on a multi-MB document: PieceTable vs a
+// single std::string (what TextEditor used to store)
+void runBenchmark() {
+    const size_t DOCUMENT_SIZE = 8 * 1024 * 1024;
+    const int EDITS = 20000;
+
+    string base;
+    base.reserve(DOCUMENT_SIZE);
+    while (base.size() < DOCUMENT_SIZE) {
+        base += "The quick brown fox jumps over the lazy dog.\n";
     }
 
-    int countLines() const {
-        if (content.empty()) return 0;
-        int count = 1;
-        for (char ch : content) {
-            if (ch == '\n') count++;
+    cout << "\n⏱️  " << EDITS << " local edits on a " << base.size() / (1024 * 1024)
+         << " MB document..." << endl;
+
+    for (int pass = 0; pass < 2; pass++) {
+        PieceTable table;
+        string plain;
+        if (pass == 0) table.load(base); else plain = base;
+
+        unsigned int rng = 12345;
+        size_t pos = base.size() / 2;
+        size_t docLength = base.size();
+
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        for (int i = 0; i < EDITS; i++) {
+            // Wander the cursor a little, then type a word or backspace
+            rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+            size_t step = rng % 64;
+            pos = (pos + step >= 32) ? min(pos + step - 32, docLength) : 0;
+
+            if (i % 4 == 3) {
+                size_t count = min<size_t>(3, pos);
+                pos -= count;
+                if (pass == 0) table.erase(pos, count); else plain.erase(pos, count);
+                docLength -= count;
+            } else {
+                if (pass == 0) table.insert(pos, "word "); else plain.insert(pos, "word ");
+                pos += 5;
+                docLength += 5;
+            }
         }
-        return count;
+        chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+
+        cout << "  " << (pass == 0 ? "Piece table: " : "std::string: ")
+             << chrono::duration_cast<chrono::milliseconds>(t1 - t0).count() << " ms";
+        if (pass == 0) cout << " (" << table.pieces() << " pieces)";
+        cout << endl;
     }
-};
+}
 
 int main() {
     TextEditor editor;
@@ -146,7 +344,15 @@ int main() {
         cout << "  7. Clear All\n";
         cout << "  8. Show Content\n";
         cout << "  9. Show Statistics\n";
-        cout << "  10. Exit\n";
+        cout << "  10. Move Cursor\n";
+        cout << "  11. Run Benchmark\n";
+        cout << "  12. Set History Memory Budget\n";
+        cout << "  13. Open File\n";
+        cout << "  14. Save File\n";
+        cout << "  15. Go To Line\n";
+        cout << "  16. Find\n";
+        cout << "  17. Replace All\n";
+        cout << "  18. Exit\n";
         cout << "  Choice: ";
         cin >> choice;
         cin.ignore();
@@ -158,7 +364,7 @@ int main() {
             editor.insertText(text);
         }
         else if (choice == 2) {
-            int count;
+            size_t count;
             cout << "  Delete how many characters? ";
             cin >> count;
             editor.deleteText(count);
@@ -185,6 +391,48 @@ int main() {
             editor.showStats();
         }
         else if (choice == 10) {
+            size_t position;
+            cout << "  Move cursor to position: ";
+            cin >> position;
+            editor.moveCursor(position);
+        }
+        else if (choice == 11) {
+            runBenchmark();
+        }
+        else if (choice == 12) {
+            size_t bytes;
+            cout << "  Budget in bytes: ";
+            cin >> bytes;
+            editor.setHistoryBudget(bytes);
+        }
+        else if (choice == 13 || choice == 14) {
+            string path;
+            cout << "  File path: ";
+            getline(cin >> ws, path);
+            if (choice == 13) editor.openFile(path);
+            else editor.saveFile(path);
+        }
+        else if (choice == 15) {
+            size_t line;
+            cout << "  Line number: ";
+            cin >> line;
+            editor.goToLine(line);
+        }
+        else if (choice == 16) {
+            string pattern;
+            cout << "  Find: ";
+            getline(cin, pattern);
+            editor.find(pattern);
+        }
+        else if (choice == 17) {
+            string pattern, replacement;
+            cout << "  Find: ";
+            getline(cin, pattern);
+            cout << "  Replace with: ";
+            getline(cin, replacement);
+            editor.replaceAll(pattern, replacement);
+        }
+        else if (choice == 18) {
             cout << "\n  Goodbye!\n";
             break;
         }
@@ -0,0 +1,222 @@
+/*
+ * ============================================================================
+ * LIBRARY FILE - BINARY LIBRARY + PLAYER STATE, LOADED BY MEMORY MAPPING
+ * ============================================================================
+ * Layout (native byte order, every array 4-byte aligned):
+ *   LibraryFileHeader
+ *   SongRecord     records[songCount]
+ *   uint32_t       artistOffsets[artistCount + 1]
+ *   uint32_t       playCounts[songCount]
+ *   int32_t        queue[queueCount]      library positions
+ *   int32_t        history[historyCount]  song IDs, oldest first
+ *   char           titles[titleBytes]
+ *   char           artists[artistBytes]
+ *
+ * open() maps the file and checks it once in O(n); the song library is
+ * then attached to the mapped arrays directly, so loading a library of
+ * millions of songs allocates nothing per song.
+ * ============================================================================
+ */
+
+#ifndef LIBRARY_FILE_H
+#define LIBRARY_FILE_H
+
+#include "MappedFile.h"
+#include "SongLibrary.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+using namespace std;
+
+struct LibraryFileHeader {
+    char magic[4];         // "PLYL"
+    uint32_t version;
+    uint32_t songCount;
+    uint32_t artistCount;
+    uint32_t titleBytes;
+    uint32_t artistBytes;
+    uint32_t queueCount;
+    uint32_t historyCount;
+    uint32_t historyDepth;
+    uint32_t nextId;
+    int32_t currentIndex;  // -1 if nothing has been played
+    uint32_t repeatMode;
+};
+
+// Player state saved alongside the library
+struct PlayerState {
+    vector<uint32_t> playCounts;
+    vector<int32_t> queue;
+    vector<int32_t> history;
+    uint32_t historyDepth;
+    uint32_t nextId;
+    int32_t currentIndex;
+    bool repeatMode;
+};
+
+class LibraryFile {
+private:
+    MappedFile file;
+    const LibraryFileHeader* head;
+    const SongRecord* recordData;
+    const uint32_t* artistOffsetData;
+    const uint32_t* playCountData;
+    const int32_t* queueData;
+    const int32_t* historyData;
+    const char* titleData;
+    const char* artistData;
+
+    static const uint32_t VERSION = 1;
+
+    static uint64_t expectedSize(const LibraryFileHeader& h) {
+        return sizeof(LibraryFileHeader) + (uint64_t)h.songCount * sizeof(SongRecord) +
+               ((uint64_t)h.artistCount + 1 + h.songCount + h.queueCount + h.historyCount) * 4 +
+               h.titleBytes + h.artistBytes;
+    }
+
+    // Every offset, ID and position must be in range before anything reads it
+    bool validate() const {
+        const LibraryFileHeader& h = *head;
+        if (artistOffsetData[0] != 0 || artistOffsetData[h.artistCount] != h.artistBytes) return false;
+        for (uint32_t i = 0; i < h.artistCount; i++) {
+            if (artistOffsetData[i] > artistOffsetData[i + 1]) return false;
+        }
+
+        vector<bool> seenId(h.nextId, false);
+        uint32_t lastTitle = 0;
+        for (uint32_t i = 0; i < h.songCount; i++) {
+            const SongRecord& song = recordData[i];
+            if (song.titleOffset < lastTitle || song.titleOffset > h.titleBytes) return false;
+            if (song.artistId >= h.artistCount) return false;
+            if (song.id == 0 || song.id >= h.nextId || seenId[song.id]) return false;
+            seenId[song.id] = true;
+            lastTitle = song.titleOffset;
+        }
+
+        for (uint32_t i = 0; i < h.queueCount; i++) {
+            if (queueData[i] < 0 || (uint32_t)queueData[i] >= h.songCount) return false;
+        }
+        if (h.historyCount > h.historyDepth) return false;
+        for (uint32_t i = 0; i < h.historyCount; i++) {
+            if (historyData[i] <= 0 || (uint32_t)historyData[i] >= h.nextId || !seenId[historyData[i]]) return false;
+        }
+        if (h.currentIndex < -1 || (h.currentIndex >= 0 && (uint32_t)h.currentIndex >= h.songCount)) return false;
+        return h.currentIndex != -1 || h.historyCount == 0; // Something was played if there is history
+    }
+
+    // Not copyable: owns the mapping
+    LibraryFile(const LibraryFile&);
+    LibraryFile& operator=(const LibraryFile&);
+
+public:
+    LibraryFile() : head(nullptr) {}
+
+    // Maps and checks a library file; on failure the object is left empty
+    bool open(const string& path) {
+        close();
+        if (!file.open(path)) return false;
+
+        const char* data = file.begin();
+        if (file.length() < sizeof(LibraryFileHeader)) {
+            close();
+            return false;
+        }
+        head = (const LibraryFileHeader*)data;
+        if (memcmp(head->magic, "PLYL", 4) != 0 || head->version != VERSION ||
+            file.length() != expectedSize(*head) || head->nextId == 0 ||
+            head->nextId > (uint64_t)head->songCount + 1) { // IDs are sequential and never removed
+            close();
+            return false;
+        }
+
+        const char* cursor = data + sizeof(LibraryFileHeader);
+        recordData = (const SongRecord*)cursor;
+        cursor += head->songCount * sizeof(SongRecord);
+        artistOffsetData = (const uint32_t*)cursor;
+        cursor += (head->artistCount + 1) * sizeof(uint32_t);
+        playCountData = (const uint32_t*)cursor;
+        cursor += head->songCount * sizeof(uint32_t);
+        queueData = (const int32_t*)cursor;
+        cursor += head->queueCount * sizeof(int32_t);
+        historyData = (const int32_t*)cursor;
+        cursor += head->historyCount * sizeof(int32_t);
+        titleData = cursor;
+        artistData = cursor + head->titleBytes;
+
+        if (!validate()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        file.close();
+        head = nullptr;
+    }
+
+    void swap(LibraryFile& other) {
+        file.swap(other.file);
+        std::swap(head, other.head);
+        std::swap(recordData, other.recordData);
+        std::swap(artistOffsetData, other.artistOffsetData);
+        std::swap(playCountData, other.playCountData);
+        std::swap(queueData, other.queueData);
+        std::swap(historyData, other.historyData);
+        std::swap(titleData, other.titleData);
+        std::swap(artistData, other.artistData);
+    }
+
+    const LibraryFileHeader& header() const { return *head; }
+
+    // Points the library at the mapped arrays; valid while this file is open
+    void attachTo(SongLibrary& library) const {
+        library.attach(recordData, head->songCount, titleData, head->titleBytes,
+                       artistData, artistOffsetData, head->artistCount);
+    }
+
+    const uint32_t* playCounts() const { return playCountData; }
+    const int32_t* queue() const { return queueData; }
+    const int32_t* history() const { return historyData; }
+
+    // Writes to a temporary file renamed over `path`, so saving over the
+    // mapped file the library was loaded from is safe
+    static bool save(const string& path, const SongLibrary& library, const PlayerState& state) {
+        LibraryFileHeader h;
+        memcpy(h.magic, "PLYL", 4);
+        h.version = VERSION;
+        h.songCount = (uint32_t)library.size();
+        h.artistCount = (uint32_t)library.artistCount();
+        h.titleBytes = (uint32_t)library.titleArrayLength();
+        h.artistBytes = (uint32_t)library.artistArrayLength();
+        h.queueCount = (uint32_t)state.queue.size();
+        h.historyCount = (uint32_t)state.history.size();
+        h.historyDepth = state.historyDepth;
+        h.nextId = state.nextId;
+        h.currentIndex = state.currentIndex;
+        h.repeatMode = state.repeatMode ? 1 : 0;
+
+        string tempPath = path + ".tmp";
+        ofstream out(tempPath.c_str(), ios::binary | ios::trunc);
+        if (!out) return false;
+        out.write((const char*)&h, sizeof(h));
+        out.write((const char*)library.recordArray(), h.songCount * sizeof(SongRecord));
+        out.write((const char*)library.artistOffsetArray(), (h.artistCount + 1) * sizeof(uint32_t));
+        out.write((const char*)state.playCounts.data(), h.songCount * sizeof(uint32_t));
+        out.write((const char*)state.queue.data(), h.queueCount * sizeof(int32_t));
+        out.write((const char*)state.history.data(), h.historyCount * sizeof(int32_t));
+        out.write(library.titleArray(), h.titleBytes);
+        out.write(library.artistArray(), h.artistBytes);
+        out.close();
+        if (!out) {
+            remove(tempPath.c_str());
+            return false;
+        }
+        return replaceFile(tempPath, path);
+    }
+};
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ * ============================================================================
+ * MAPPED FILE - READ-ONLY MEMORY MAPPING
+ * ============================================================================
+ * Maps a whole file into the address space without reading it. Pages are
+ * loaded by the OS on first access, so opening a multi-GB file is O(1) and
+ * only the parts that are actually viewed or edited occupy memory.
+ * ============================================================================
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <utility>
+#include <cstddef>
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Moves a fully written temporary file over `path` in one step, replacing
+// any existing file. On failure `path` is left exactly as it was and the
+// temporary file is removed.
+inline bool replaceFile(const string& tempPath, const string& path) {
+#ifdef _WIN32
+    bool ok = MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool ok = rename(tempPath.c_str(), path.c_str()) == 0;
+#endif
+    if (!ok) remove(tempPath.c_str());
+    return ok;
+}
+
+class MappedFile {
+private:
+    const char* data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE fileHandle;
+    HANDLE mappingHandle;
+#endif
+
+    // Not copyable: owns the mapping
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+public:
+    MappedFile() : data(nullptr), size(0) {
+#ifdef _WIN32
+        fileHandle = INVALID_HANDLE_VALUE;
+        mappingHandle = nullptr;
+#endif
+    }
+
+    ~MappedFile() {
+        close();
+    }
+
+    bool open(const string& path) {
+        close();
+
+#ifdef _WIN32
+        // Share delete access so a save can replace the file while it is mapped
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize)) {
+            close();
+            return false;
+        }
+        size = (size_t)fileSize.QuadPart;
+        if (size == 0) return true; // Empty files cannot be mapped
+
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle == nullptr) {
+            close();
+            return false;
+        }
+        data = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr) {
+            close();
+            return false;
+        }
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size = (size_t)info.st_size;
+
+        if (size > 0) {
+            void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                ::close(fd);
+                size = 0;
+                return false;
+            }
+            data = (const char*)mapping;
+        }
+        ::close(fd); // The mapping stays valid after the descriptor is closed
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data != nullptr) UnmapViewOfFile(data);
+        if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+        if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+        mappingHandle = nullptr;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if (data != nullptr) munmap((void*)data, size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    void swap(MappedFile& other) {
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+#ifdef _WIN32
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+#endif
+    }
+
+    const char* begin() const { return data; }
+    size_t length() const { return size; }
+};
+
+#endif
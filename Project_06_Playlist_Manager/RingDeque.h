@@ -0,0 +1,88 @@
+/*
+ * ============================================================================
+ * RING DEQUE - CIRCULAR BUFFER DOUBLE-ENDED QUEUE
+ * ============================================================================
+ * Elements live in one array used as a circle: `head` is the index of the
+ * front element and the rest follow it, wrapping around the end. Pushing
+ * or popping at either end is O(1) (amortized when the buffer grows), and
+ * any position can be read or swapped in place, which lets the playlist
+ * shuffle or step back without rebuilding the queue.
+ * ============================================================================
+ */
+
+#ifndef RING_DEQUE_H
+#define RING_DEQUE_H
+
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+template <typename T>
+class RingDeque {
+private:
+    vector<T> buffer; // Capacity is always a power of two
+    size_t head;
+    size_t count;
+
+    size_t wrap(size_t index) const {
+        return index & (buffer.size() - 1);
+    }
+
+    // Doubles the capacity, unrolling the elements to start at index 0
+    void grow() {
+        vector<T> bigger(buffer.size() * 2);
+        for (size_t i = 0; i < count; i++) {
+            bigger[i] = buffer[wrap(head + i)];
+        }
+        buffer.swap(bigger);
+        head = 0;
+    }
+
+public:
+    explicit RingDeque(size_t initialCapacity = 16) : head(0), count(0) {
+        size_t capacity = 1;
+        while (capacity < initialCapacity) capacity *= 2;
+        buffer.resize(capacity);
+    }
+
+    void push_back(const T& value) {
+        if (count == buffer.size()) grow();
+        buffer[wrap(head + count)] = value;
+        count++;
+    }
+
+    void push_front(const T& value) {
+        if (count == buffer.size()) grow();
+        head = wrap(head + buffer.size() - 1);
+        buffer[head] = value;
+        count++;
+    }
+
+    void pop_front() {
+        head = wrap(head + 1);
+        count--;
+    }
+
+    void pop_back() {
+        count--;
+    }
+
+    T& front() { return buffer[head]; }
+    const T& front() const { return buffer[head]; }
+    T& back() { return buffer[wrap(head + count - 1)]; }
+    const T& back() const { return buffer[wrap(head + count - 1)]; }
+
+    // i-th element from the front
+    T& operator[](size_t i) { return buffer[wrap(head + i)]; }
+    const T& operator[](size_t i) const { return buffer[wrap(head + i)]; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+};
+
+#endif
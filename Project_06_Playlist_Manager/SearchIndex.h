@@ -0,0 +1,192 @@
+/*
+ * ============================================================================
+ * SEARCH INDEX - INVERTED INDEX OVER SONG TITLES AND ARTISTS
+ * ============================================================================
+ * Titles and artists are split into lowercase terms (runs of letters and
+ * digits; non-ASCII bytes are kept as part of a term). Each term maps to a
+ * posting list: the library positions of the songs containing it, in
+ * ascending order because songs are only ever appended.
+ *
+ * A query matches songs containing every query term. The last term is a
+ * prefix ("bohem rhap" finds "Bohemian Rhapsody"), found by binary search
+ * in a sorted term list. The exact terms are intersected first, smallest
+ * list first, skipping through the larger list by binary search, so a
+ * rare term keeps the whole query cheap no matter how common the others
+ * are. The prefix is then only checked against those candidates, so a
+ * short prefix like "a" never has its (possibly huge) union built. A
+ * prefix on its own is answered by a k-way heap merge of its lists.
+ * ============================================================================
+ */
+
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <queue>
+#include <functional>
+#include <utility>
+using namespace std;
+
+class SearchIndex {
+private:
+    unordered_map<string, vector<int> > postings;
+    vector<string> sortedTerms; // Every key of postings, sorted, for prefix lookup
+    bool termsDirty;            // A new term was added since sortedTerms was built
+
+    static bool isTermChar(unsigned char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+    }
+
+    static void tokenize(const string& text, vector<string>& terms) {
+        string term;
+        for (size_t i = 0; i <= text.size(); i++) {
+            unsigned char c = i < text.size() ? text[i] : ' ';
+            if (isTermChar(c)) {
+                term += (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : (char)c;
+            } else if (!term.empty()) {
+                terms.push_back(term);
+                term.clear();
+            }
+        }
+    }
+
+    void addTerms(int position, const string& text) {
+        vector<string> terms;
+        tokenize(text, terms);
+        for (size_t i = 0; i < terms.size(); i++) {
+            vector<int>& list = postings[terms[i]];
+            if (list.empty()) termsDirty = true;
+            if (list.empty() || list.back() != position) list.push_back(position);
+        }
+    }
+
+    // Range of sortedTerms starting with prefix
+    pair<vector<string>::const_iterator, vector<string>::const_iterator> prefixRange(const string& prefix) {
+        if (termsDirty) {
+            sortedTerms.clear();
+            sortedTerms.reserve(postings.size());
+            for (unordered_map<string, vector<int> >::const_iterator it = postings.begin(); it != postings.end(); ++it) {
+                sortedTerms.push_back(it->first);
+            }
+            sort(sortedTerms.begin(), sortedTerms.end());
+            termsDirty = false;
+        }
+
+        vector<string>::const_iterator first = lower_bound(sortedTerms.begin(), sortedTerms.end(), prefix);
+        vector<string>::const_iterator last = first;
+        while (last != sortedTerms.end() && last->compare(0, prefix.size(), prefix) == 0) ++last;
+        return make_pair(first, last);
+    }
+
+    // Sorted union of the posting lists of every term starting with prefix,
+    // merged through a heap of list cursors: O(n log k) for k lists
+    vector<int> prefixPostings(const string& prefix) {
+        pair<vector<string>::const_iterator, vector<string>::const_iterator> range = prefixRange(prefix);
+        typedef pair<int, pair<const int*, const int*> > Cursor; // (value, (next, end))
+        priority_queue<Cursor, vector<Cursor>, greater<Cursor> > heads;
+        for (vector<string>::const_iterator it = range.first; it != range.second; ++it) {
+            const vector<int>& list = postings[*it];
+            if (!list.empty()) heads.push(Cursor(list[0], make_pair(list.data() + 1, list.data() + list.size())));
+        }
+
+        vector<int> merged;
+        while (!heads.empty()) {
+            Cursor head = heads.top();
+            heads.pop();
+            if (merged.empty() || merged.back() != head.first) merged.push_back(head.first);
+            if (head.second.first != head.second.second) {
+                heads.push(Cursor(*head.second.first, make_pair(head.second.first + 1, head.second.second)));
+            }
+        }
+        return merged;
+    }
+
+    // Keeps the candidates contained by some term starting with prefix.
+    // Each term's list is only probed at the candidates not yet matched,
+    // and the scan stops as soon as every candidate has matched.
+    void keepPrefixMatches(vector<int>& candidates, const string& prefix) {
+        pair<vector<string>::const_iterator, vector<string>::const_iterator> range = prefixRange(prefix);
+        vector<char> matched(candidates.size(), 0);
+        size_t unmatched = candidates.size();
+        for (vector<string>::const_iterator it = range.first; it != range.second && unmatched > 0; ++it) {
+            const vector<int>& list = postings[*it];
+            vector<int>::const_iterator from = list.begin();
+            for (size_t i = 0; i < candidates.size() && from != list.end(); i++) {
+                if (matched[i]) continue;
+                from = lower_bound(from, list.end(), candidates[i]);
+                if (from != list.end() && *from == candidates[i]) {
+                    matched[i] = 1;
+                    unmatched--;
+                }
+            }
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (matched[i]) candidates[kept++] = candidates[i];
+        }
+        candidates.resize(kept);
+    }
+
+    // Keeps the entries of `result` that also appear in `other`
+    static void intersectInto(vector<int>& result, const vector<int>& other) {
+        size_t kept = 0;
+        vector<int>::const_iterator from = other.begin();
+        for (size_t i = 0; i < result.size() && from != other.end(); i++) {
+            from = lower_bound(from, other.end(), result[i]);
+            if (from != other.end() && *from == result[i]) result[kept++] = result[i];
+        }
+        result.resize(kept);
+    }
+
+public:
+    SearchIndex() : termsDirty(false) {}
+
+    // Songs must be added in increasing position order
+    void addSong(int position, const string& title, const string& artist) {
+        addTerms(position, title);
+        addTerms(position, artist);
+    }
+
+    void clear() {
+        postings.clear();
+        sortedTerms.clear();
+        termsDirty = false;
+    }
+
+    size_t termCount() const {
+        return postings.size();
+    }
+
+    // Library positions of songs matching every term of the query, ascending
+    vector<int> search(const string& query) {
+        vector<string> terms;
+        tokenize(query, terms);
+        if (terms.empty()) return vector<int>();
+
+        if (terms.size() == 1) return prefixPostings(terms[0]);
+
+        // Exact terms first; a missing one means no results at all
+        vector<const vector<int>*> lists;
+        for (size_t i = 0; i + 1 < terms.size(); i++) {
+            unordered_map<string, vector<int> >::const_iterator it = postings.find(terms[i]);
+            if (it == postings.end()) return vector<int>();
+            lists.push_back(&it->second);
+        }
+
+        sort(lists.begin(), lists.end(), [](const vector<int>* a, const vector<int>* b) {
+            return a->size() < b->size();
+        });
+        vector<int> result(*lists[0]);
+        for (size_t i = 1; i < lists.size() && !result.empty(); i++) {
+            intersectInto(result, *lists[i]);
+        }
+        if (!result.empty()) keepPrefixMatches(result, terms.back());
+        return result;
+    }
+};
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * ============================================================================
+ * SHUFFLE ENGINE - FAST PRNG, LAZY FISHER-YATES, WEIGHTED ALIAS TABLE
+ * ============================================================================
+ * Xoshiro256**   Small, fast 64-bit generator (replaces rand()).
+ * LazyShuffle    Draws a uniform random permutation of [0, n) one element
+ *                at a time in O(1), without permuting (or even allocating)
+ *                all n positions up front: only displaced slots are stored.
+ * AliasTable     Vose's alias method: built in O(n) from weights, then
+ *                samples an index with probability proportional to its
+ *                weight in O(1).
+ * ============================================================================
+ */
+
+#ifndef SHUFFLE_ENGINE_H
+#define SHUFFLE_ENGINE_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+class Xoshiro256 {
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+    explicit Xoshiro256(uint64_t seed = 0x9E3779B97F4A7C15ULL) {
+        reseed(seed);
+    }
+
+    // Expands one seed into the full state with splitmix64
+    void reseed(uint64_t seed) {
+        for (int i = 0; i < 4; i++) {
+            seed += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            state[i] = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform integer in [0, bound) without modulo bias
+    uint64_t nextBelow(uint64_t bound) {
+        uint64_t threshold = (0 - bound) % bound;
+        while (true) {
+            uint64_t r = next();
+            if (r >= threshold) return r % bound;
+        }
+    }
+
+    // Uniform double in [0, 1)
+    double nextDouble() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+class LazyShuffle {
+private:
+    size_t total;
+    size_t drawn;
+    // Sparse view of the array being shuffled: slot -> value, only for
+    // slots whose value is no longer their own index
+    unordered_map<size_t, size_t> displaced;
+
+    size_t valueAt(size_t slot) const {
+        unordered_map<size_t, size_t>::const_iterator it = displaced.find(slot);
+        return it == displaced.end() ? slot : it->second;
+    }
+
+public:
+    explicit LazyShuffle(size_t n = 0) : total(n), drawn(0) {}
+
+    void reset(size_t n) {
+        total = n;
+        drawn = 0;
+        displaced.clear();
+    }
+
+    // Adds elements total..n-1 to the undrawn part of the current pass.
+    // Their slots still hold their own index, so nothing else changes.
+    void grow(size_t n) {
+        if (n > total) total = n;
+    }
+
+    size_t size() const { return total; }
+    size_t remaining() const { return total - drawn; }
+
+    // Next element of the permutation: one Fisher-Yates step, O(1) expected
+    size_t next(Xoshiro256& rng) {
+        size_t j = drawn + (size_t)rng.nextBelow(total - drawn);
+        size_t value = valueAt(j);
+        displaced[j] = valueAt(drawn);
+        displaced.erase(drawn); // Slot `drawn` is never read again
+        drawn++;
+        return value;
+    }
+};
+
+class AliasTable {
+private:
+    vector<double> probability; // Chance of keeping column i
+    vector<size_t> alias;       // Otherwise take alias[i]
+
+public:
+    // Weights must be non-negative with a positive sum
+    void build(const vector<double>& weights) {
+        size_t n = weights.size();
+        probability.assign(n, 0.0);
+        alias.assign(n, 0);
+        if (n == 0) return;
+
+        double sum = 0;
+        for (size_t i = 0; i < n; i++) sum += weights[i];
+
+        // Scale so the average column is exactly 1
+        vector<double> scaled(n);
+        vector<size_t> small, large;
+        for (size_t i = 0; i < n; i++) {
+            scaled[i] = weights[i] * n / sum;
+            if (scaled[i] < 1.0) small.push_back(i);
+            else large.push_back(i);
+        }
+
+        // Each small column is topped up by one large column
+        while (!small.empty() && !large.empty()) {
+            size_t s = small.back();
+            small.pop_back();
+            size_t l = large.back();
+            probability[s] = scaled[s];
+            alias[s] = l;
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+
+        // Leftovers are full columns (up to rounding error)
+        for (size_t i = 0; i < large.size(); i++) probability[large[i]] = 1.0;
+        for (size_t i = 0; i < small.size(); i++) probability[small[i]] = 1.0;
+    }
+
+    size_t size() const { return probability.size(); }
+
+    size_t sample(Xoshiro256& rng) const {
+        size_t column = (size_t)rng.nextBelow(probability.size());
+        return rng.nextDouble() < probability[column] ? column : alias[column];
+    }
+};
+
+#endif
@@ -0,0 +1,215 @@
+/*
+ * ============================================================================
+ * SONG LIBRARY - COMPACT INTERNED SONG STORAGE
+ * ============================================================================
+ * Songs are stored as packed 16-byte records instead of objects owning two
+ * strings each:
+ *   - every title is appended to one string arena; a record keeps only the
+ *     offset, and the title runs up to the next record's offset
+ *   - artist names are interned: each distinct name is stored once and
+ *     records refer to it by a 32-bit artist ID
+ * Scans such as total duration or listing an artist's songs walk one
+ * contiguous array of small records.
+ *
+ * The library can also be attached to those arrays in place, e.g. straight
+ * out of a memory-mapped library file, without any per-song allocation.
+ * The first add() after that copies them into memory it owns.
+ * ============================================================================
+ */
+
+#ifndef SONG_LIBRARY_H
+#define SONG_LIBRARY_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+using namespace std;
+
+struct SongRecord {
+    uint32_t id;
+    uint32_t titleOffset; // Start of the title in the title arena
+    uint32_t artistId;    // Index into the artist table
+    uint32_t duration;    // in seconds
+};
+
+class SongLibrary {
+private:
+    // Owned storage, used once the library has been modified
+    vector<SongRecord> records;
+    string titleArena;
+    string artistArena;
+    vector<uint32_t> artistOffsets; // Artist ID -> start in artistArena, plus an end marker
+
+    // What every accessor reads: the owned storage above or attached memory
+    const SongRecord* recordData;
+    size_t recordCount;
+    const char* titleData;
+    size_t titleBytes;
+    const char* artistData;
+    const uint32_t* artistOffsetData;
+    size_t artistTotal;
+    bool attached;
+
+    // Name -> artist ID, for interning; built on first use after attach()
+    mutable unordered_map<string, uint32_t> artistIds;
+    mutable bool artistIdsBuilt;
+
+    void syncViews() {
+        recordData = records.data();
+        recordCount = records.size();
+        titleData = titleArena.data();
+        titleBytes = titleArena.size();
+        artistData = artistArena.data();
+        artistOffsetData = artistOffsets.data();
+        artistTotal = artistOffsets.size() - 1;
+    }
+
+    // Copies attached memory into owned storage so it can grow
+    void detach() {
+        records.assign(recordData, recordData + recordCount);
+        titleArena.assign(titleData, titleBytes);
+        artistArena.assign(artistData, artistOffsetData[artistTotal]);
+        artistOffsets.assign(artistOffsetData, artistOffsetData + artistTotal + 1);
+        attached = false;
+        syncViews();
+    }
+
+    void buildArtistIds() const {
+        if (artistIdsBuilt) return;
+        artistIds.clear();
+        for (size_t i = 0; i < artistTotal; i++) artistIds[artistName((uint32_t)i)] = (uint32_t)i;
+        artistIdsBuilt = true;
+    }
+
+    // Not copyable: the views point into this object's own storage
+    SongLibrary(const SongLibrary&);
+    SongLibrary& operator=(const SongLibrary&);
+
+public:
+    SongLibrary() : artistOffsets(1, 0), attached(false), artistIdsBuilt(true) {
+        syncViews();
+    }
+
+    // Appends a song and returns its position
+    size_t add(uint32_t id, const string& title, const string& artist, uint32_t duration) {
+        if (attached) detach();
+        buildArtistIds();
+
+        uint32_t artistId;
+        unordered_map<string, uint32_t>::const_iterator it = artistIds.find(artist);
+        if (it != artistIds.end()) {
+            artistId = it->second;
+        } else {
+            artistId = (uint32_t)artistOffsets.size() - 1;
+            artistIds[artist] = artistId;
+            artistArena += artist;
+            artistOffsets.push_back((uint32_t)artistArena.size());
+        }
+
+        SongRecord record = {id, (uint32_t)titleArena.size(), artistId, duration};
+        titleArena += title;
+        records.push_back(record);
+        syncViews();
+        return records.size() - 1;
+    }
+
+    // Uses the given arrays in place (same layout as the owned storage:
+    // artistOffsets has artistCount + 1 entries). They must stay valid
+    // until the next add(), attach() or clear().
+    void attach(const SongRecord* songs, size_t songCount, const char* titles, size_t titleLength,
+                const char* artists, const uint32_t* offsets, size_t artistCount) {
+        records.clear();
+        titleArena.clear();
+        artistArena.clear();
+        artistOffsets.assign(1, 0);
+        artistIds.clear();
+        artistIdsBuilt = false;
+
+        recordData = songs;
+        recordCount = songCount;
+        titleData = titles;
+        titleBytes = titleLength;
+        artistData = artists;
+        artistOffsetData = offsets;
+        artistTotal = artistCount;
+        attached = true;
+    }
+
+    void clear() {
+        records.clear();
+        titleArena.clear();
+        artistArena.clear();
+        artistOffsets.assign(1, 0);
+        artistIds.clear();
+        artistIdsBuilt = true;
+        attached = false;
+        syncViews();
+    }
+
+    size_t size() const { return recordCount; }
+    bool empty() const { return recordCount == 0; }
+    const SongRecord& operator[](size_t i) const { return recordData[i]; }
+
+    // Raw arrays, e.g. for writing the library to a file
+    const SongRecord* recordArray() const { return recordData; }
+    const char* titleArray() const { return titleData; }
+    size_t titleArrayLength() const { return titleBytes; }
+    const char* artistArray() const { return artistData; }
+    size_t artistArrayLength() const { return artistOffsetData[artistTotal]; }
+    const uint32_t* artistOffsetArray() const { return artistOffsetData; }
+
+    string title(size_t i) const {
+        size_t end = i + 1 < recordCount ? recordData[i + 1].titleOffset : titleBytes;
+        return string(titleData + recordData[i].titleOffset, end - recordData[i].titleOffset);
+    }
+
+    size_t artistCount() const { return artistTotal; }
+
+    string artistName(uint32_t artistId) const {
+        return string(artistData + artistOffsetData[artistId], artistOffsetData[artistId + 1] - artistOffsetData[artistId]);
+    }
+
+    string artist(size_t i) const { return artistName(recordData[i].artistId); }
+
+    // Artist ID for a name, or -1 if no song has that artist
+    long findArtist(const string& name) const {
+        buildArtistIds();
+        unordered_map<string, uint32_t>::const_iterator it = artistIds.find(name);
+        return it == artistIds.end() ? -1 : (long)it->second;
+    }
+
+    // Positions of every song by the artist, in library order
+    vector<size_t> songsByArtist(uint32_t artistId) const {
+        vector<size_t> positions;
+        for (size_t i = 0; i < recordCount; i++) {
+            if (recordData[i].artistId == artistId) positions.push_back(i);
+        }
+        return positions;
+    }
+
+    uint64_t totalDuration() const {
+        uint64_t total = 0;
+        for (size_t i = 0; i < recordCount; i++) total += recordData[i].duration;
+        return total;
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = recordCount * sizeof(SongRecord) + titleBytes + artistArrayLength() +
+                       (artistTotal + 1) * sizeof(uint32_t);
+        for (unordered_map<string, uint32_t>::const_iterator it = artistIds.begin(); it != artistIds.end(); ++it) {
+            bytes += it->first.size() + sizeof(uint32_t);
+        }
+        return bytes;
+    }
+
+    void display(size_t i) const {
+        const SongRecord& song = recordData[i];
+        cout << "  [" << song.id << "] " << title(i) << " - " << artist(i)
+             << " (" << song.duration/60 << ":" << (song.duration%60 < 10 ? "0" : "")
+             << song.duration%60 << ")" << endl;
+    }
+};
+
+#endif
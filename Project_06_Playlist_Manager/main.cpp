@@ -2,64 +2,100 @@
  * ============================================================================
  * PROJECT #6: PLAYLIST MANAGER (MUSIC/VIDEO QUEUE)
  * ============================================================================
- * Data Structure: Circular Queue + Stack for recently played
- * Features: Play queue, shuffle, repeat, recently played history
+ * Data Structure: Circular Queue (ring deque of song indices) + bounded ring
+ *                 buffer for recently played + packed, interned song records
+ * Features: Play queue, shuffle, repeat, recently played history,
+ *           lazy shuffle play and play-count weighted smart shuffle,
+ *           title/artist search through an inverted index, binary library
+ *           file (memory-mapped on load) that also keeps queue and history
  * ============================================================================
  */
 
+#include "RingDeque.h"
+#include "SongLibrary.h"
+#include "ShuffleEngine.h"
+#include "SearchIndex.h"
+#include "LibraryFile.h"
 #include <iostream>
 #include <string>
-#include <queue>
-#include <stack>
+#include <sstream>
 #include <vector>
 #include <algorithm>
-#include <cstdlib>
-#include <ctime>
+#include <chrono>
+#include <limits>
 using namespace std;
 
-struct Song {
-    int id;
-    string title;
-    string artist;
-    int duration; // in seconds
-
-    void display() const {
-        cout << "  [" << id << "] " << title << " - " << artist 
-             << " (" << duration/60 << ":" << (duration%60 < 10 ? "0" : "") 
-             << duration%60 << ")" << endl;
-    }
-};
-
 class PlaylistManager {
 private:
-    queue<Song> playQueue;
-    stack<Song> recentlyPlayed;
-    vector<Song> allSongs;
+    RingDeque<int> playQueue;      // Positions in the library; songs are never copied
+    RingDeque<int> recentlyPlayed; // Song IDs, oldest at the front
+    size_t historyDepth;           // Maximum entries kept in recentlyPlayed
+    SongLibrary library;
+    vector<int> songIndex; // songIndex[id] = position in library, -1 if none
+    vector<unsigned int> playCounts; // playCounts[i] = plays of library song i
+    Xoshiro256 rng;
+    LazyShuffle libraryShuffle; // Current pass over the library for shuffle play
+    AliasTable playWeights;     // Smart shuffle sampler, rebuilt when counts change
+    bool weightsDirty;
+    SearchIndex searchIndex;    // Title and artist terms -> library positions
+    size_t indexedSongs;        // Songs [0, indexedSongs) are in searchIndex
+    LibraryFile libraryFile;    // Mapped file the library may be attached to
     int nextId;
     bool repeatMode;
-    Song currentSong;
+    int currentIndex; // Position in library of the current song, -1 if none
     bool isPlaying;
 
+    // IDs come from nextId, so a dense ID-addressed vector resolves them in O(1)
+    int findSong(int songId) const {
+        if (songId <= 0 || songId >= (int)songIndex.size()) return -1;
+        return songIndex[songId];
+    }
+
 public:
-    PlaylistManager() : nextId(1), repeatMode(false), isPlaying(false) {
-        srand(time(0));
+    static const size_t DEFAULT_HISTORY_DEPTH = 50;
+
+    PlaylistManager()
+        : recentlyPlayed(DEFAULT_HISTORY_DEPTH), historyDepth(DEFAULT_HISTORY_DEPTH), songIndex(1, -1), weightsDirty(true),
+          indexedSongs(0), nextId(1), repeatMode(false), currentIndex(-1), isPlaying(false) {
+        rng.reseed((uint64_t)chrono::high_resolution_clock::now().time_since_epoch().count());
     }
 
     void addSong(const string& title, const string& artist, int duration) {
-        Song song = {nextId++, title, artist, duration};
-        allSongs.push_back(song);
+        int id = nextId++;
+        size_t position = library.add(id, title, artist, duration);
+        songIndex.resize(nextId, -1);
+        songIndex[id] = position;
+        playCounts.push_back(0);
+        libraryShuffle.grow(library.size()); // The new song joins the current pass
+        weightsDirty = true;
         cout << "✅ Song added to library!" << endl;
     }
 
     void addToQueue(int songId) {
-        for (const auto& song : allSongs) {
-            if (song.id == songId) {
-                playQueue.push(song);
-                cout << "✅ Added to play queue!" << endl;
-                return;
+        int index = findSong(songId);
+        if (index < 0) {
+            cout << "❌ Song not found!" << endl;
+            return;
+        }
+        playQueue.push_back(index);
+        cout << "✅ Added to play queue!" << endl;
+    }
+
+    // Enqueues a list of IDs in one call; unknown IDs are skipped
+    void addToQueue(const vector<int>& songIds) {
+        int added = 0;
+        for (size_t i = 0; i < songIds.size(); i++) {
+            int index = findSong(songIds[i]);
+            if (index >= 0) {
+                playQueue.push_back(index);
+                added++;
             }
         }
-        cout << "❌ Song not found!" << endl;
+        cout << "✅ Added " << added << " song(s) to play queue!";
+        if (added < (int)songIds.size()) {
+            cout << " (" << songIds.size() - added << " not found)";
+        }
+        cout << endl;
     }
 
     void play() {
@@ -68,17 +104,23 @@ public:
             return;
         }
 
-        currentSong = playQueue.front();
-        playQueue.pop();
+        currentIndex = playQueue.front();
+        playQueue.pop_front();
         isPlaying = true;
+        playCounts[currentIndex]++;
+        weightsDirty = true;
 
         cout << "\n🎵 Now Playing:" << endl;
-        currentSong.display();
+        library.display(currentIndex);
 
-        recentlyPlayed.push(currentSong);
+        // Bounded history: the oldest entry is dropped once it is full
+        if (historyDepth > 0) {
+            if (recentlyPlayed.size() == historyDepth) recentlyPlayed.pop_front();
+            recentlyPlayed.push_back(library[currentIndex].id);
+        }
 
         if (repeatMode) {
-            playQueue.push(currentSong);
+            playQueue.push_back(currentIndex);
         }
     }
 
@@ -97,38 +139,65 @@ public:
             return;
         }
 
-        recentlyPlayed.pop(); // Remove current
-        Song prev = recentlyPlayed.top();
-        recentlyPlayed.pop();
+        recentlyPlayed.pop_back(); // Remove current
+        int prevIndex = findSong(recentlyPlayed.back());
+        recentlyPlayed.pop_back();
 
-        playQueue.push(currentSong); // Put current back in queue
-        
-        // Move remaining queue to front
-        queue<Song> temp;
-        temp.push(prev);
-        while (!playQueue.empty()) {
-            temp.push(playQueue.front());
-            playQueue.pop();
-        }
-        playQueue = temp;
+        playQueue.push_back(currentIndex); // Put current back in queue
+        playQueue.push_front(prevIndex);   // Previous song plays next
 
         play();
     }
 
     void shuffle() {
-        vector<Song> temp;
-        while (!playQueue.empty()) {
-            temp.push_back(playQueue.front());
-            playQueue.pop();
+        // Fisher-Yates, in place on the ring
+        for (size_t i = playQueue.size(); i > 1; i--) {
+            size_t j = (size_t)rng.nextBelow(i);
+            swap(playQueue[i - 1], playQueue[j]);
         }
 
-        random_shuffle(temp.begin(), temp.end());
+        cout << "🔀 Queue shuffled!" << endl;
+    }
 
-        for (const auto& song : temp) {
-            playQueue.push(song);
+    // Enqueues `count` songs from a random pass over the whole library. Each
+    // song is drawn in O(1) and no song repeats until the pass is used up.
+    void shufflePlay(int count) {
+        if (library.empty()) {
+            cout << "❌ Library is empty!" << endl;
+            return;
+        }
+        if (count <= 0) {
+            cout << "❌ Number of songs must be positive!" << endl;
+            return;
+        }
+        for (int i = 0; i < count; i++) {
+            if (libraryShuffle.remaining() == 0) libraryShuffle.reset(library.size());
+            playQueue.push_back((int)libraryShuffle.next(rng));
         }
+        cout << "🔀 Added " << count << " shuffled song(s) to queue!" << endl;
+    }
 
-        cout << "🔀 Queue shuffled!" << endl;
+    // Enqueues `count` songs picked in proportion to (play count + 1), so
+    // favourites come up more often but unplayed songs still get a chance
+    void smartShuffle(int count) {
+        if (library.empty()) {
+            cout << "❌ Library is empty!" << endl;
+            return;
+        }
+        if (count <= 0) {
+            cout << "❌ Number of songs must be positive!" << endl;
+            return;
+        }
+        if (weightsDirty) {
+            vector<double> weights(playCounts.size());
+            for (size_t i = 0; i < playCounts.size(); i++) weights[i] = playCounts[i] + 1.0;
+            playWeights.build(weights);
+            weightsDirty = false;
+        }
+        for (int i = 0; i < count; i++) {
+            playQueue.push_back((int)playWeights.sample(rng));
+        }
+        cout << "✨ Added " << count << " smart-shuffled song(s) to queue!" << endl;
     }
 
     void toggleRepeat() {
@@ -143,62 +212,173 @@ public:
         }
 
         cout << "\n📋 Play Queue:" << endl;
-        queue<Song> temp = playQueue;
-        int pos = 1;
-        while (!temp.empty()) {
-            cout << "  " << pos++ << ". ";
-            temp.front().display();
-            temp.pop();
+        for (size_t i = 0; i < playQueue.size(); i++) {
+            cout << "  " << i + 1 << ". ";
+            library.display(playQueue[i]);
         }
     }
 
-    void showRecentlyPlayed() const {
+    // Shows the last `count` songs played, most recent first (0 = all)
+    void showRecentlyPlayed(size_t count) const {
         if (recentlyPlayed.empty()) {
             cout << "\n⚠️  No recently played songs!" << endl;
             return;
         }
 
+        vector<int> ids = lastPlayed(count == 0 ? recentlyPlayed.size() : count);
         cout << "\n🕐 Recently Played:" << endl;
-        stack<Song> temp = recentlyPlayed;
-        int pos = 1;
-        while (!temp.empty()) {
-            cout << "  " << pos++ << ". ";
-            temp.top().display();
-            temp.pop();
+        for (size_t i = 0; i < ids.size(); i++) {
+            cout << "  " << i + 1 << ". ";
+            library.display(findSong(ids[i]));
         }
     }
 
+    // IDs of the last k songs played, most recent first, in O(k)
+    vector<int> lastPlayed(size_t k) const {
+        k = min(k, recentlyPlayed.size());
+        vector<int> ids;
+        ids.reserve(k);
+        for (size_t i = 0; i < k; i++) {
+            ids.push_back(recentlyPlayed[recentlyPlayed.size() - 1 - i]);
+        }
+        return ids;
+    }
+
+    void setHistoryDepth(size_t depth) {
+        historyDepth = depth;
+        while (recentlyPlayed.size() > historyDepth) recentlyPlayed.pop_front();
+        cout << "✅ History depth set to " << historyDepth << "." << endl;
+    }
+
     void showLibrary() const {
-        if (allSongs.empty()) {
+        if (library.empty()) {
             cout << "\n⚠️  No songs in library!" << endl;
             return;
         }
 
         cout << "\n📚 Song Library:" << endl;
-        for (const auto& song : allSongs) {
-            song.display();
+        for (size_t i = 0; i < library.size(); i++) {
+            library.display(i);
+        }
+
+        uint64_t total = library.totalDuration();
+        cout << "  " << library.size() << " song(s) by " << library.artistCount() << " artist(s), "
+             << total / 3600 << "h " << total / 60 % 60 << "m total, "
+             << library.memoryBytes() << " bytes of song data" << endl;
+    }
+
+    void showArtist(const string& name) const {
+        long artistId = library.findArtist(name);
+        if (artistId < 0) {
+            cout << "❌ Artist not found!" << endl;
+            return;
+        }
+
+        vector<size_t> positions = library.songsByArtist((uint32_t)artistId);
+        cout << "\n🎤 " << name << " (" << positions.size() << " song(s)):" << endl;
+        for (size_t i = 0; i < positions.size(); i++) {
+            library.display(positions[i]);
         }
     }
 
+    // Songs whose title or artist contain every word of the query; the last
+    // word may be partial
+    void search(const string& query, size_t maxShown = 20) {
+        // Index songs added or loaded since the last search
+        for (; indexedSongs < library.size(); indexedSongs++) {
+            searchIndex.addSong(indexedSongs, library.title(indexedSongs), library.artist(indexedSongs));
+        }
+
+        vector<int> matches = searchIndex.search(query);
+        if (matches.empty()) {
+            cout << "\n⚠️  No songs match \"" << query << "\"" << endl;
+            return;
+        }
+
+        cout << "\n🔍 " << matches.size() << " match(es):" << endl;
+        for (size_t i = 0; i < matches.size() && i < maxShown; i++) {
+            library.display(matches[i]);
+        }
+        if (matches.size() > maxShown) {
+            cout << "  ... and " << matches.size() - maxShown << " more" << endl;
+        }
+    }
+
+    bool saveLibrary(const string& path) const {
+        PlayerState state;
+        state.playCounts = playCounts;
+        for (size_t i = 0; i < playQueue.size(); i++) state.queue.push_back(playQueue[i]);
+        for (size_t i = 0; i < recentlyPlayed.size(); i++) state.history.push_back(recentlyPlayed[i]);
+        state.historyDepth = (uint32_t)historyDepth;
+        state.nextId = nextId;
+        state.currentIndex = currentIndex;
+        state.repeatMode = repeatMode;
+
+        if (!LibraryFile::save(path, library, state)) {
+            cout << "❌ Could not save library to " << path << endl;
+            return false;
+        }
+        cout << "💾 Saved " << library.size() << " song(s) to " << path << endl;
+        return true;
+    }
+
+    // Replaces the library, queue and history with the file's contents.
+    // Songs are read straight from the mapped file; nothing changes if the
+    // file is missing or invalid.
+    bool loadLibrary(const string& path) {
+        LibraryFile file;
+        if (!file.open(path)) return false;
+
+        libraryFile.swap(file);
+        libraryFile.attachTo(library);
+        const LibraryFileHeader& header = libraryFile.header();
+
+        songIndex.assign(header.nextId, -1);
+        for (size_t i = 0; i < library.size(); i++) songIndex[library[i].id] = i;
+        playCounts.assign(libraryFile.playCounts(), libraryFile.playCounts() + header.songCount);
+
+        playQueue.clear();
+        for (uint32_t i = 0; i < header.queueCount; i++) playQueue.push_back(libraryFile.queue()[i]);
+        historyDepth = header.historyDepth;
+        recentlyPlayed.clear();
+        for (uint32_t i = 0; i < header.historyCount; i++) recentlyPlayed.push_back(libraryFile.history()[i]);
+
+        nextId = header.nextId;
+        currentIndex = header.currentIndex;
+        repeatMode = header.repeatMode != 0;
+        isPlaying = false;
+
+        searchIndex.clear();
+        indexedSongs = 0;
+        libraryShuffle.reset(library.size());
+        weightsDirty = true;
+
+        cout << "📂 Loaded " << library.size() << " song(s) from " << path << endl;
+        return true;
+    }
+
     void clearQueue() {
-        while (!playQueue.empty()) playQueue.pop();
+        playQueue.clear();
         cout << "🗑️  Queue cleared!" << endl;
     }
 };
 
 int main() {
+    const string libraryPath = "playlist_library.dat";
     PlaylistManager player;
 
     cout << "\n========================================================\n";
     cout << "             PLAYLIST MANAGER                           \n";
     cout << "========================================================\n";
 
-    // Add sample songs
-    player.addSong("Shape of You", "Ed Sheeran", 234);
-    player.addSong("Blinding Lights", "The Weeknd", 200);
-    player.addSong("Bohemian Rhapsody", "Queen", 354);
-    player.addSong("Imagine", "John Lennon", 183);
-    player.addSong("Hotel California", "Eagles", 391);
+    // Restore the saved library, or start with sample songs
+    if (!player.loadLibrary(libraryPath)) {
+        player.addSong("Shape of You", "Ed Sheeran", 234);
+        player.addSong("Blinding Lights", "The Weeknd", 200);
+        player.addSong("Bohemian Rhapsody", "Queen", 354);
+        player.addSong("Imagine", "John Lennon", 183);
+        player.addSong("Hotel California", "Eagles", 391);
+    }
 
     int choice;
     while (true) {
@@ -212,7 +392,13 @@ int main() {
         cout << "  8. Toggle Repeat Mode\n";
         cout << "  9. Recently Played\n";
         cout << "  10. Clear Queue\n";
-        cout << "  11. Exit\n";
+        cout << "  11. Set History Depth\n";
+        cout << "  12. Shuffle Play from Library\n";
+        cout << "  13. Smart Shuffle (by play count)\n";
+        cout << "  14. Search Library\n";
+        cout << "  15. Songs by Artist\n";
+        cout << "  16. Save Library\n";
+        cout << "  17. Exit (saves library)\n";
         cout << "  Choice: ";
         cin >> choice;
         cin.ignore();
@@ -230,19 +416,60 @@ int main() {
         }
         else if (choice == 2) player.showLibrary();
         else if (choice == 3) {
+            string line;
+            cout << "  Enter Song ID(s): ";
+            getline(cin, line);
+            istringstream in(line);
+            vector<int> ids;
             int id;
-            cout << "  Enter Song ID: ";
-            cin >> id;
-            player.addToQueue(id);
+            while (in >> id) ids.push_back(id);
+            if (ids.size() == 1) player.addToQueue(ids[0]);
+            else if (!ids.empty()) player.addToQueue(ids);
         }
         else if (choice == 4) player.showQueue();
         else if (choice == 5) player.play();
         else if (choice == 6) player.previous();
         else if (choice == 7) player.shuffle();
         else if (choice == 8) player.toggleRepeat();
-        else if (choice == 9) player.showRecentlyPlayed();
+        else if (choice == 9) {
+            size_t count;
+            cout << "  How many (0 = all): ";
+            cin >> count;
+            player.showRecentlyPlayed(count);
+        }
         else if (choice == 10) player.clearQueue();
         else if (choice == 11) {
+            size_t depth;
+            cout << "  History depth: ";
+            cin >> depth;
+            player.setHistoryDepth(depth);
+        }
+        else if (choice == 12 || choice == 13) {
+            int count;
+            cout << "  Number of songs: ";
+            if (!(cin >> count) || count <= 0) {
+                cout << "❌ Number of songs must be positive!" << endl;
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            }
+            else if (choice == 12) player.shufflePlay(count);
+            else player.smartShuffle(count);
+        }
+        else if (choice == 14) {
+            string query;
+            cout << "  Search: ";
+            getline(cin, query);
+            player.search(query);
+        }
+        else if (choice == 15) {
+            string artist;
+            cout << "  Artist: ";
+            getline(cin, artist);
+            player.showArtist(artist);
+        }
+        else if (choice == 16) player.saveLibrary(libraryPath);
+        else if (choice == 17) {
+            player.saveLibrary(libraryPath);
             cout << "\n  🎵 Thanks for using Playlist Manager!\n";
             break;
         }
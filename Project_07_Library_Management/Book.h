@@ -2,7 +2,8 @@
  * ============================================================================
  * PROJECT #7: LIBRARY BOOK MANAGEMENT SYSTEM
  * ============================================================================
- * Data Structure: BST (for book catalog) + Priority Queue (for issue requests)
+ * Data Structure: ID-indexed array (book catalog) + per-book priority queues
+ *                 (issue requests)
  * Features: Add/search books, issue/return, priority-based request queue
  * ============================================================================
  */
@@ -12,6 +13,7 @@
 
 #include <string>
 #include <iostream>
+#include <atomic>
 using namespace std;
 
 struct Book {
@@ -19,13 +21,36 @@ struct Book {
     string title;
     string author;
     int totalCopies;
-    int availableCopies;
+    atomic<int> availableCopies; // Changed by issue/return from many threads
 
     Book() : bookId(0), totalCopies(0), availableCopies(0) {}
     
     Book(int id, string t, string a, int copies) 
         : bookId(id), title(t), author(a), totalCopies(copies), availableCopies(copies) {}
 
+    // Atomics are not copyable; copying a Book takes a snapshot of the count
+    Book(const Book& other)
+        : bookId(other.bookId), title(other.title), author(other.author),
+          totalCopies(other.totalCopies), availableCopies(other.availableCopies.load()) {}
+
+    Book& operator=(const Book& other) {
+        bookId = other.bookId;
+        title = other.title;
+        author = other.author;
+        totalCopies = other.totalCopies;
+        availableCopies.store(other.availableCopies.load());
+        return *this;
+    }
+
+    // Takes one copy if any is left; lock-free compare-and-swap loop
+    bool tryTakeCopy() {
+        int copies = availableCopies.load();
+        while (copies > 0) {
+            if (availableCopies.compare_exchange_weak(copies, copies - 1)) return true;
+        }
+        return false;
+    }
+
     void display() const {
         cout << "  [" << bookId << "] " << title << " by " << author 
              << " (" << availableCopies << "/" << totalCopies << " available)" << endl;
@@ -36,10 +61,29 @@ struct IssueRequest {
     string studentName;
     int bookId;
     int priority; // 1 = High, 2 = Medium, 3 = Low
+    unsigned long sequence; // Arrival order; equal priorities are served first come, first served
 
     bool operator<(const IssueRequest& other) const {
-        return priority > other.priority; // Min heap (higher priority first)
+        if (priority != other.priority) {
+            return priority > other.priority; // Min heap (higher priority first)
+        }
+        return sequence > other.sequence;
     }
 };
 
+enum CirculationStatus {
+    ISSUED,         // A copy was taken
+    WAITLISTED,     // No copy left; the request joined the book's waiting queue
+    RETURNED,       // The copy went back on the shelf
+    HANDED_OVER,    // The returned copy went straight to the next waiter
+    BOOK_NOT_FOUND,
+    STORAGE_ERROR   // The log could not be written: the change is not saved
+};
+
+struct CirculationResult {
+    CirculationStatus status;
+    string servedStudent; // Reader who got the copy, for HANDED_OVER
+    int availableCopies;  // Shelf copies right after the operation
+};
+
 #endif
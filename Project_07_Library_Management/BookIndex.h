@@ -0,0 +1,265 @@
+/*
+ * ============================================================================
+ * BOOK INDEX - INVERTED INDEX OVER TITLES AND AUTHORS
+ * ============================================================================
+ * Titles and authors are split into lowercase terms (runs of letters and
+ * digits). Each term has a posting list sorted by book ID; a posting also
+ * records whether the term came from the title, the author, or both.
+ *
+ * A query returns the books containing every query term, the last of which
+ * may be a prefix ("algo" finds "Algorithms"). The exact terms' posting
+ * lists are intersected smallest first by galloping: for each candidate
+ * the larger list is probed at steps 1, 2, 4, ... past the previous hit,
+ * then binary searched, so the cost follows the smaller list rather than
+ * the larger one. Only the surviving candidates are then galloped through
+ * the lists of the terms starting with the prefix, so a one-letter prefix
+ * never walks the catalog. A query that is only a prefix merges those
+ * lists with a heap.
+ *
+ * Results are ranked: a term found in the title scores 2, in the author 1.
+ * Equal scores keep ID order.
+ * ============================================================================
+ */
+
+#ifndef BOOK_INDEX_H
+#define BOOK_INDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <queue>
+#include <functional>
+#include <utility>
+using namespace std;
+
+enum BookField {
+    TITLE_FIELD = 1,
+    AUTHOR_FIELD = 2
+};
+
+struct Posting {
+    int bookId;
+    unsigned char fields; // BookField bits
+
+    bool operator<(const Posting& other) const {
+        return bookId < other.bookId;
+    }
+};
+
+struct SearchHit {
+    int bookId;
+    int score;
+};
+
+class BookIndex {
+private:
+    typedef vector<Posting> PostingList;
+
+    unordered_map<string, PostingList> postings;
+    vector<string> sortedTerms; // Every key of postings, sorted, for prefix lookup
+    bool termsDirty;
+
+    static void tokenize(const string& text, vector<string>& terms) {
+        string term;
+        for (size_t i = 0; i <= text.size(); i++) {
+            char c = i < text.size() ? text[i] : ' ';
+            if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) {
+                term += c;
+            } else if (c >= 'A' && c <= 'Z') {
+                term += (char)(c - 'A' + 'a');
+            } else if (!term.empty()) {
+                terms.push_back(term);
+                term.clear();
+            }
+        }
+    }
+
+    void addTerms(int bookId, const string& text, unsigned char field) {
+        vector<string> terms;
+        tokenize(text, terms);
+        for (size_t i = 0; i < terms.size(); i++) {
+            PostingList& list = postings[terms[i]];
+            if (list.empty()) termsDirty = true;
+
+            Posting posting = {bookId, field};
+            if (list.empty() || list.back().bookId < bookId) {
+                list.push_back(posting); // Usual case: IDs arrive in increasing order
+                continue;
+            }
+            PostingList::iterator it = lower_bound(list.begin(), list.end(), posting);
+            if (it != list.end() && it->bookId == bookId) it->fields |= field;
+            else list.insert(it, posting);
+        }
+    }
+
+    // Range of sortedTerms starting with prefix
+    pair<vector<string>::const_iterator, vector<string>::const_iterator> prefixRange(const string& prefix) {
+        if (termsDirty) {
+            sortedTerms.clear();
+            for (unordered_map<string, PostingList>::const_iterator it = postings.begin(); it != postings.end(); ++it) {
+                sortedTerms.push_back(it->first);
+            }
+            sort(sortedTerms.begin(), sortedTerms.end());
+            termsDirty = false;
+        }
+
+        vector<string>::const_iterator first = lower_bound(sortedTerms.begin(), sortedTerms.end(), prefix);
+        vector<string>::const_iterator last = first;
+        while (last != sortedTerms.end() && last->compare(0, prefix.size(), prefix) == 0) ++last;
+        return make_pair(first, last);
+    }
+
+    // Union of the lists of every term starting with prefix, by book ID,
+    // merged through a heap of list cursors: O(n log k) for k lists.
+    // A book in several lists keeps every field it matched in.
+    PostingList prefixPostings(const string& prefix) {
+        pair<vector<string>::const_iterator, vector<string>::const_iterator> range = prefixRange(prefix);
+        typedef pair<int, pair<const Posting*, const Posting*> > Cursor; // (book ID, (current, end))
+        priority_queue<Cursor, vector<Cursor>, greater<Cursor> > heads;
+        for (vector<string>::const_iterator it = range.first; it != range.second; ++it) {
+            const PostingList& list = postings[*it];
+            if (!list.empty()) heads.push(Cursor(list[0].bookId, make_pair(list.data(), list.data() + list.size())));
+        }
+
+        PostingList merged;
+        while (!heads.empty()) {
+            Cursor head = heads.top();
+            heads.pop();
+            const Posting& posting = *head.second.first;
+            if (!merged.empty() && merged.back().bookId == posting.bookId) merged.back().fields |= posting.fields;
+            else merged.push_back(posting);
+            if (++head.second.first != head.second.second) {
+                heads.push(Cursor(head.second.first->bookId, head.second));
+            }
+        }
+        return merged;
+    }
+
+    // Keeps the candidate hits found in some list of a term starting with
+    // prefix, adding the score of the fields matched there. Each list is
+    // only galloped through at the candidates, and the scan stops once
+    // every candidate has matched in both fields.
+    void keepPrefixMatches(vector<SearchHit>& candidates, const string& prefix) {
+        pair<vector<string>::const_iterator, vector<string>::const_iterator> range = prefixRange(prefix);
+        const unsigned char BOTH_FIELDS = TITLE_FIELD | AUTHOR_FIELD;
+        vector<unsigned char> matched(candidates.size(), 0);
+        size_t incomplete = candidates.size();
+        for (vector<string>::const_iterator it = range.first; it != range.second && incomplete > 0; ++it) {
+            const PostingList& list = postings[*it];
+            size_t cursor = 0;
+            for (size_t i = 0; i < candidates.size(); i++) {
+                if (matched[i] == BOTH_FIELDS) continue;
+                cursor = gallop(list, cursor, candidates[i].bookId);
+                if (cursor == list.size()) break;
+                if (list[cursor].bookId != candidates[i].bookId) continue;
+                matched[i] |= list[cursor].fields;
+                if (matched[i] == BOTH_FIELDS) incomplete--;
+            }
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (matched[i] == 0) continue;
+            candidates[kept] = candidates[i];
+            candidates[kept++].score += scoreOf(matched[i]);
+        }
+        candidates.resize(kept);
+    }
+
+    // Books containing every term but the last, in ID order, scored by
+    // the fields they matched in
+    void intersectExact(const vector<string>& terms, vector<SearchHit>& hits) {
+        vector<const PostingList*> lists;
+        for (size_t i = 0; i + 1 < terms.size(); i++) {
+            unordered_map<string, PostingList>::const_iterator it = postings.find(terms[i]);
+            if (it == postings.end()) return;
+            lists.push_back(&it->second);
+        }
+
+        sort(lists.begin(), lists.end(), [](const PostingList* a, const PostingList* b) {
+            return a->size() < b->size();
+        });
+
+        // Walk the smallest list; gallop through the others
+        const PostingList& smallest = *lists[0];
+        vector<size_t> cursor(lists.size(), 0);
+        bool exhausted = false; // Some list has no IDs left to match
+        for (size_t i = 0; i < smallest.size() && !exhausted; i++) {
+            int bookId = smallest[i].bookId;
+            int score = scoreOf(smallest[i].fields);
+            bool inAll = true;
+            for (size_t k = 1; k < lists.size() && inAll; k++) {
+                cursor[k] = gallop(*lists[k], cursor[k], bookId);
+                if (cursor[k] == lists[k]->size()) exhausted = true;
+                if (exhausted || (*lists[k])[cursor[k]].bookId != bookId) inAll = false;
+                else score += scoreOf((*lists[k])[cursor[k]].fields);
+            }
+            if (inAll) {
+                SearchHit hit = {bookId, score};
+                hits.push_back(hit);
+            }
+        }
+    }
+
+    // First position at or after `from` whose ID is >= bookId
+    static size_t gallop(const PostingList& list, size_t from, int bookId) {
+        size_t step = 1;
+        size_t high = from;
+        while (high < list.size() && list[high].bookId < bookId) {
+            from = high + 1;
+            high += step;
+            step *= 2;
+        }
+        Posting key = {bookId, 0};
+        return lower_bound(list.begin() + from, list.begin() + min(high, list.size()), key) - list.begin();
+    }
+
+    static int scoreOf(unsigned char fields) {
+        return ((fields & TITLE_FIELD) ? 2 : 0) + ((fields & AUTHOR_FIELD) ? 1 : 0);
+    }
+
+public:
+    BookIndex() : termsDirty(false) {}
+
+    void addBook(int bookId, const string& title, const string& author) {
+        addTerms(bookId, title, TITLE_FIELD);
+        addTerms(bookId, author, AUTHOR_FIELD);
+    }
+
+    void clear() {
+        postings.clear();
+        sortedTerms.clear();
+        termsDirty = false;
+    }
+
+    size_t termCount() const {
+        return postings.size();
+    }
+
+    // Books matching every term of the query, best score first
+    vector<SearchHit> search(const string& query) {
+        vector<SearchHit> hits;
+        vector<string> terms;
+        tokenize(query, terms);
+        if (terms.empty()) return hits;
+
+        if (terms.size() == 1) {
+            PostingList matches = prefixPostings(terms[0]);
+            for (size_t i = 0; i < matches.size(); i++) {
+                SearchHit hit = {matches[i].bookId, scoreOf(matches[i].fields)};
+                hits.push_back(hit);
+            }
+        } else {
+            intersectExact(terms, hits);
+            if (!hits.empty()) keepPrefixMatches(hits, terms.back());
+        }
+
+        stable_sort(hits.begin(), hits.end(), [](const SearchHit& a, const SearchHit& b) {
+            return a.score > b.score;
+        });
+        return hits;
+    }
+};
+
+#endif
@@ -1,8 +1,19 @@
 /*
  * ============================================================================
- * LIBRARY CATALOG - BST IMPLEMENTATION
+ * LIBRARY CATALOG - DENSE ID-INDEXED SEGMENTED ARRAY
  * ============================================================================
- * Binary Search Tree for efficient book searching by ID
+ * Book IDs are handed out sequentially, so book N lives in slot N - 1.
+ * Slots are stored in segments of doubling size (64, 128, 256, ...) that
+ * are never moved or freed once allocated, so lookup by ID is a little
+ * arithmetic and an index, and a Book* stays valid until the catalog
+ * is cleared.
+ *
+ * That makes adding books safe while other threads issue and return
+ * them: readers never lock, a new segment is published with a single
+ * atomic store after it is built, and a slot is marked filled only after
+ * its book has been written. Adds are serialized with each other (and
+ * with title/author search, whose inverted index they update) by a mutex.
+ * An ID that was never added leaves an unfilled slot.
  * ============================================================================
  */
 
@@ -10,86 +21,143 @@
 #define LIBRARY_CATALOG_H
 
 #include "Book.h"
-
-class BookNode {
-public:
-    Book data;
-    BookNode* left;
-    BookNode* right;
-
-    BookNode(const Book& book) : data(book), left(nullptr), right(nullptr) {}
-};
+#include "BookIndex.h"
+#include <atomic>
+#include <mutex>
 
 class LibraryCatalog {
 private:
-    BookNode* root;
+    struct Slot {
+        Book book;
+        atomic<bool> filled; // Set once book is fully written
+
+        Slot() : filled(false) {}
+    };
+
+    static const size_t FIRST_SEGMENT = 64;
+    static const int SEGMENT_COUNT = 26; // 64 * (2^26 - 1) slots: every positive int ID
+
+    atomic<Slot*> segments[SEGMENT_COUNT]; // Segment k holds FIRST_SEGMENT << k slots
+    atomic<size_t> slotLimit;              // One past the highest slot ever filled
+    atomic<size_t> bookCount;
+    mutex writeLock;                       // Serializes addBook() and searchIndex use
+    BookIndex searchIndex;
+
+    // Segment k starts at slot FIRST_SEGMENT * (2^k - 1)
+    static void locate(size_t slot, int& segment, size_t& offset) {
+        size_t blocks = slot / FIRST_SEGMENT + 1;
+        segment = 0;
+        while (blocks >>= 1) segment++;
+        offset = slot - FIRST_SEGMENT * (((size_t)1 << segment) - 1);
+    }
 
-    BookNode* insert(BookNode* node, const Book& book) {
-        if (node == nullptr) {
-            return new BookNode(book);
-        }
+    Slot* slotAt(size_t slot) const {
+        int segment;
+        size_t offset;
+        locate(slot, segment, offset);
+        Slot* base = segments[segment].load(memory_order_acquire);
+        return base != nullptr ? base + offset : nullptr;
+    }
 
-        if (book.bookId < node->data.bookId) {
-            node->left = insert(node->left, book);
-        } else if (book.bookId > node->data.bookId) {
-            node->right = insert(node->right, book);
-        }
+    // Not copyable: books are handed out by pointer
+    LibraryCatalog(const LibraryCatalog&);
+    LibraryCatalog& operator=(const LibraryCatalog&);
 
-        return node;
+public:
+    LibraryCatalog() : slotLimit(0), bookCount(0) {
+        for (int k = 0; k < SEGMENT_COUNT; k++) segments[k].store(nullptr);
     }
 
-    BookNode* search(BookNode* node, int bookId) {
-        if (node == nullptr || node->data.bookId == bookId) {
-            return node;
-        }
+    ~LibraryCatalog() {
+        for (int k = 0; k < SEGMENT_COUNT; k++) delete[] segments[k].load();
+    }
 
-        if (bookId < node->data.bookId) {
-            return search(node->left, bookId);
+    // Safe to call while other threads look books up
+    void addBook(const Book& book) {
+        if (book.bookId <= 0) return; // Slots are numbered from ID 1
+        lock_guard<mutex> guard(writeLock);
+
+        size_t slot = (size_t)book.bookId - 1;
+        int segment;
+        size_t offset;
+        locate(slot, segment, offset);
+        Slot* base = segments[segment].load(memory_order_relaxed);
+        if (base == nullptr) {
+            base = new Slot[FIRST_SEGMENT << segment];
+            segments[segment].store(base, memory_order_release);
         }
-        return search(node->right, bookId);
+
+        Slot& target = base[offset];
+        if (target.filled.load(memory_order_relaxed)) return; // IDs are unique, keep the existing book
+        target.book = book;
+        target.filled.store(true, memory_order_release);
+        if (slot + 1 > slotLimit.load(memory_order_relaxed)) slotLimit.store(slot + 1, memory_order_release);
+        bookCount++;
+        searchIndex.addBook(book.bookId, book.title, book.author);
     }
 
-    void inorder(BookNode* node) const {
-        if (node != nullptr) {
-            inorder(node->left);
-            node->data.display();
-            inorder(node->right);
+    // Frees every book. Only when no other thread uses the catalog and
+    // nobody holds a Book* from it.
+    void clear() {
+        lock_guard<mutex> guard(writeLock);
+        for (int k = 0; k < SEGMENT_COUNT; k++) {
+            delete[] segments[k].load();
+            segments[k].store(nullptr);
         }
+        slotLimit = 0;
+        bookCount = 0;
+        searchIndex.clear();
     }
 
-    void searchByTitle(BookNode* node, const string& title) const {
-        if (node != nullptr) {
-            searchByTitle(node->left, title);
-            if (node->data.title.find(title) != string::npos) {
-                node->data.display();
-            }
-            searchByTitle(node->right, title);
-        }
+    // Pointers stay valid until clear()
+    Book* findBook(int bookId) {
+        if (bookId <= 0 || (size_t)bookId > slotLimit.load(memory_order_acquire)) return nullptr;
+        Slot* slot = slotAt((size_t)bookId - 1);
+        return slot != nullptr && slot->filled.load(memory_order_acquire) ? &slot->book : nullptr;
     }
 
-public:
-    LibraryCatalog() : root(nullptr) {}
+    const Book* findBook(int bookId) const {
+        return const_cast<LibraryCatalog*>(this)->findBook(bookId);
+    }
 
-    void addBook(const Book& book) {
-        root = insert(root, book);
+    size_t size() const {
+        return bookCount.load();
     }
 
-    Book* findBook(int bookId) {
-        BookNode* node = search(root, bookId);
-        return (node != nullptr) ? &(node->data) : nullptr;
+    // Calls visit(book) for every book in ID order
+    template <typename Visitor>
+    void forEachBook(Visitor visit) const {
+        size_t limit = slotLimit.load(memory_order_acquire);
+        for (size_t i = 0; i < limit; i++) {
+            const Slot* slot = slotAt(i);
+            if (slot != nullptr && slot->filled.load(memory_order_acquire)) visit(slot->book);
+        }
     }
 
     void displayAll() const {
-        if (root == nullptr) {
+        if (bookCount == 0) {
             cout << "  No books in catalog!" << endl;
             return;
         }
-        inorder(root);
+        forEachBook([](const Book& book) { book.display(); });
     }
 
-    void searchBooks(const string& title) const {
-        cout << "\n  Search Results for \"" << title << "\":" << endl;
-        searchByTitle(root, title);
+    // Books whose title or author contain every word of the query (the
+    // last word may be partial), title matches first
+    void searchBooks(const string& query) {
+        cout << "\n  Search Results for \"" << query << "\":" << endl;
+        vector<SearchHit> hits;
+        {
+            lock_guard<mutex> guard(writeLock);
+            hits = searchIndex.search(query);
+        }
+        if (hits.empty()) {
+            cout << "  No matching books." << endl;
+            return;
+        }
+        for (size_t i = 0; i < hits.size(); i++) {
+            findBook(hits[i].bookId)->display();
+        }
     }
 };
 
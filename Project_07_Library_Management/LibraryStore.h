@@ -0,0 +1,338 @@
+/*
+ * ============================================================================
+ * LIBRARY STORE - BINARY ENCODING + WRITE-AHEAD LOG WITH GROUP COMMIT
+ * ============================================================================
+ * ByteWriter / ByteReader  Little helpers for the snapshot and log formats
+ *                          (native byte order, strings length-prefixed).
+ * WriteAheadLog            Append-only log of catalog and circulation
+ *                          events. Each record is
+ *                            [u32 payload length][u32 checksum][u64 LSN]
+ *                            [u8 type][payload]
+ *                          Appends go to an in-memory batch. A caller that
+ *                          needs its record on disk calls waitDurable(lsn):
+ *                          the first waiter writes the whole batch with one
+ *                          sequential write and one fsync, and everyone
+ *                          whose record was in it returns together (group
+ *                          commit). Records that arrive during a flush form
+ *                          the next batch.
+ *
+ * Replay stops quietly at the first torn or corrupt record, which can
+ * only be the tail written during a crash. An intact record the caller
+ * cannot apply makes replay fail instead.
+ *
+ * A new log is prepared aside and renamed over the old one, so a failed
+ * restart leaves the old log in place and open.
+ * ============================================================================
+ */
+
+#ifndef LIBRARY_STORE_H
+#define LIBRARY_STORE_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+using namespace std;
+
+enum LogRecordType {
+    LOG_ADD_BOOK = 1,    // bookId, copies, title, author
+    LOG_ISSUED,          // bookId
+    LOG_WAITLISTED,      // bookId, priority, sequence, studentName
+    LOG_RETURNED,        // bookId
+    LOG_HANDED_OVER      // bookId, sequence of the request served
+};
+
+// Flushes stdio buffers and forces the file's data to disk
+inline bool syncFile(FILE* f) {
+    if (fflush(f) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+// Makes a rename inside the file's directory durable. Windows has no
+// directory handle to sync, so there this is a no-op.
+inline bool syncDirectoryOf(const string& path) {
+#ifdef _WIN32
+    (void)path;
+    return true;
+#else
+    size_t slash = path.find_last_of('/');
+    string directory = slash == string::npos ? "." : path.substr(0, slash + 1);
+    int fd = open(directory.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+#endif
+}
+
+// Moves a fully written temporary file over `path` in one step, replacing
+// any existing file. On failure `path` is left exactly as it was and the
+// temporary file is removed.
+inline bool replaceFile(const string& tempPath, const string& path) {
+#ifdef _WIN32
+    bool ok = MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool ok = rename(tempPath.c_str(), path.c_str()) == 0;
+#endif
+    if (!ok) remove(tempPath.c_str());
+    return ok;
+}
+
+// FNV-1a, enough to tell a torn write from a whole record
+inline uint32_t checksumOf(const char* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+class ByteWriter {
+private:
+    string bytes;
+
+public:
+    void putInt32(int32_t value) { bytes.append((const char*)&value, sizeof(value)); }
+    void putUint32(uint32_t value) { bytes.append((const char*)&value, sizeof(value)); }
+    void putUint64(uint64_t value) { bytes.append((const char*)&value, sizeof(value)); }
+    void putByte(unsigned char value) { bytes += (char)value; }
+
+    void putString(const string& value) {
+        putUint32((uint32_t)value.size());
+        bytes += value;
+    }
+
+    const string& data() const { return bytes; }
+    void clear() { bytes.clear(); }
+};
+
+// Reads fields in order; once anything runs past the end, ok() turns false
+// and every later read returns zero
+class ByteReader {
+private:
+    const char* cursor;
+    const char* end;
+    bool valid;
+
+    bool take(void* out, size_t count) {
+        if (!valid || (size_t)(end - cursor) < count) {
+            valid = false;
+            memset(out, 0, count);
+            return false;
+        }
+        memcpy(out, cursor, count);
+        cursor += count;
+        return true;
+    }
+
+public:
+    ByteReader(const char* data, size_t length) : cursor(data), end(data + length), valid(true) {}
+
+    int32_t getInt32() { int32_t v; take(&v, sizeof(v)); return v; }
+    uint32_t getUint32() { uint32_t v; take(&v, sizeof(v)); return v; }
+    uint64_t getUint64() { uint64_t v; take(&v, sizeof(v)); return v; }
+    unsigned char getByte() { unsigned char v; take(&v, sizeof(v)); return v; }
+
+    string getString() {
+        uint32_t length = getUint32();
+        if (!valid || (size_t)(end - cursor) < length) {
+            valid = false;
+            return string();
+        }
+        string value(cursor, length);
+        cursor += length;
+        return value;
+    }
+
+    bool ok() const { return valid; }
+    bool atEnd() const { return cursor == end; }
+};
+
+class WriteAheadLog {
+private:
+    FILE* file;
+    mutex lock;
+    condition_variable flushDone;
+    string batch;         // Encoded records not yet written
+    uint64_t nextLsn;     // LSN of the next appended record
+    uint64_t durableLsn;  // Every record up to this LSN is on disk
+    bool flushing;
+    bool failed;          // A write or sync failed; nothing is durable any more
+    size_t batchCount;
+
+    static const size_t RECORD_HEADER = 4 + 4 + 8 + 1;
+
+    // Not copyable: owns the file
+    WriteAheadLog(const WriteAheadLog&);
+    WriteAheadLog& operator=(const WriteAheadLog&);
+
+public:
+    WriteAheadLog()
+        : file(nullptr), nextLsn(1), durableLsn(0), flushing(false), failed(false), batchCount(0) {}
+
+    ~WriteAheadLog() {
+        close();
+    }
+
+    // Replaces the log at path with a new, empty one whose first record
+    // gets firstLsn. Only call once everything in the old log is safe
+    // elsewhere (a synced snapshot). On failure the old log, if one was
+    // open, is left in place and stays open.
+    bool create(const string& path, uint64_t firstLsn) {
+        string tempPath = path + ".tmp";
+        FILE* fresh = fopen(tempPath.c_str(), "wb");
+        if (fresh == nullptr) return false;
+        bool written = syncFile(fresh);
+        if (fclose(fresh) != 0 || !written) {
+            remove(tempPath.c_str());
+            return false;
+        }
+
+        bool hadLog = isOpen();
+        close(); // Windows cannot rename over an open file
+        if (!replaceFile(tempPath, path)) {
+            if (hadLog) {
+                file = fopen(path.c_str(), "ab");
+                if (file == nullptr) failed = true; // Later appends can never become durable
+            }
+            return false;
+        }
+
+        file = fopen(path.c_str(), "ab");
+        nextLsn = firstLsn;
+        durableLsn = firstLsn - 1;
+        // If the rename itself might not survive a crash, records written
+        // to the new log could vanish with it
+        failed = file == nullptr || !syncDirectoryOf(path);
+        batchCount = 0;
+        return !failed;
+    }
+
+    void close() {
+        if (file == nullptr) return;
+        unique_lock<mutex> guard(lock);
+        while (flushing) flushDone.wait(guard);
+        if (!batch.empty()) {
+            fwrite(batch.data(), 1, batch.size(), file);
+            syncFile(file);
+            batch.clear();
+        }
+        fclose(file);
+        file = nullptr;
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    // True once a write or sync has failed; nothing appended since can be
+    // made durable
+    bool hasFailed() {
+        lock_guard<mutex> guard(lock);
+        return failed;
+    }
+    size_t batchesWritten() const { return batchCount; }
+    uint64_t lastLsn() const { return nextLsn - 1; }
+
+    // Queues a record for the next batch and returns its LSN
+    uint64_t append(unsigned char type, const string& payload) {
+        lock_guard<mutex> guard(lock);
+        uint64_t lsn = nextLsn++;
+
+        ByteWriter body;
+        body.putUint64(lsn);
+        body.putByte(type);
+        string checked = body.data() + payload;
+
+        ByteWriter header;
+        header.putUint32((uint32_t)payload.size());
+        header.putUint32(checksumOf(checked.data(), checked.size()));
+        batch += header.data();
+        batch += checked;
+        return lsn;
+    }
+
+    // Blocks until the record with this LSN is on disk; false if the log
+    // could not be written
+    bool waitDurable(uint64_t lsn) {
+        unique_lock<mutex> guard(lock);
+        while (durableLsn < lsn && !failed) {
+            if (flushing) {
+                flushDone.wait(guard); // Someone else is writing; ride the next batch
+                continue;
+            }
+
+            // Become the leader: write everything queued so far
+            string writing;
+            writing.swap(batch);
+            uint64_t batchEnd = nextLsn - 1;
+            flushing = true;
+            guard.unlock();
+
+            bool ok = file != nullptr && fwrite(writing.data(), 1, writing.size(), file) == writing.size() &&
+                      syncFile(file);
+
+            guard.lock();
+            flushing = false;
+            if (ok) {
+                durableLsn = batchEnd;
+                batchCount++;
+            } else {
+                failed = true;
+            }
+            flushDone.notify_all();
+        }
+        return durableLsn >= lsn;
+    }
+
+    // Calls apply(lsn, type, reader) for each intact record in order,
+    // stopping quietly at a torn or corrupt tail. Returns false if the file
+    // exists but cannot be read, or if apply() rejects an intact record.
+    template <typename Apply>
+    static bool replay(const string& path, Apply apply) {
+        ifstream in(path.c_str(), ios::binary);
+        if (!in) return true; // No log yet
+        string data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        if (in.bad()) return false;
+
+        size_t offset = 0;
+        while (data.size() - offset >= RECORD_HEADER) {
+            ByteReader header(data.data() + offset, 8);
+            uint32_t length = header.getUint32();
+            uint32_t checksum = header.getUint32();
+            size_t checkedLength = 9 + (size_t)length;
+            if (data.size() - offset - 8 < checkedLength) break; // Torn tail
+            const char* checked = data.data() + offset + 8;
+            if (checksumOf(checked, checkedLength) != checksum) break;
+
+            ByteReader record(checked, checkedLength);
+            uint64_t lsn = record.getUint64();
+            unsigned char type = record.getByte();
+            if (!apply(lsn, type, record)) return false;
+            offset += 8 + checkedLength;
+        }
+        return true;
+    }
+};
+
+#endif
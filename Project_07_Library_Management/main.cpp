@@ -2,27 +2,350 @@
  * ============================================================================
  * PROJECT #7: LIBRARY BOOK MANAGEMENT SYSTEM - MAIN
  * ============================================================================
+ * Issue and return may be called from many threads at once (circulation
+ * desks, self-checkout kiosks). Copy counts are atomics taken with a
+ * compare-and-swap loop, and waiting queues are split into shards by book
+ * ID, each with its own mutex, so only requests for books in the same
+ * shard ever wait on each other. Books may be added while circulation is
+ * running: IDs come from an atomic counter and the catalog never moves a
+ * book once it is stored.
+ *
+ * With storage open, every change is first written to an append-only log
+ * (see LibraryStore.h) and only acknowledged once its batch is on disk.
+ * If the log cannot be written the change is reported as not saved: it
+ * stays in memory for this session but is lost on exit, because from then
+ * on further changes and checkpoints are refused. Startup loads the
+ * last snapshot, replays the log after it, then writes a fresh snapshot
+ * and starts an empty log (a checkpoint). A damaged snapshot, a log
+ * record that cannot be applied or a gap in the log stops startup
+ * without touching either file.
+ * ============================================================================
  */
 
 #include "Book.h"
 #include "LibraryCatalog.h"
-#include <queue>
+#include "LibraryStore.h"
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
 #include <iostream>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <random>
 using namespace std;
 
+// Waiting queues for the books whose ID falls in this shard
+struct WaitShard {
+    mutex lock;
+    // One binary heap of requests per book (std heap functions over a
+    // vector), so a return only looks at that book's waiters
+    unordered_map<int, vector<IssueRequest> > queues;
+};
+
 class LibraryManager {
 private:
+    static const int SHARD_COUNT = 64;
+    static const int FIRST_BOOK_ID = 101;
+
     LibraryCatalog catalog;
-    priority_queue<IssueRequest> requestQueue;
-    int nextBookId;
+    WaitShard shards[SHARD_COUNT];
+    atomic<size_t> waitingCount;
+    atomic<unsigned long> nextSequence;
+    atomic<int> nextBookId;
+    WriteAheadLog wal;
+    string storagePath; // Base name of the .snapshot and .wal files, empty if not persistent
+
+    WaitShard& shardFor(int bookId) {
+        return shards[(unsigned int)bookId % SHARD_COUNT];
+    }
+
+    // Queues an event in the log and returns its LSN (0 without storage).
+    // Called before the change is made visible, so the log order never
+    // contradicts what other threads observed.
+    uint64_t logEvent(LogRecordType type, const ByteWriter& payload) {
+        return storagePath.empty() ? 0 : wal.append(type, payload.data());
+    }
+
+    // Waits for a logged event to reach disk; false if it never will
+    bool makeDurable(uint64_t lsn) {
+        return lsn == 0 || wal.waitDurable(lsn);
+    }
+
+    // Forgets everything loaded so far. Only while no other thread runs.
+    void resetState() {
+        catalog.clear();
+        for (int s = 0; s < SHARD_COUNT; s++) shards[s].queues.clear();
+        waitingCount = 0;
+        nextSequence = 0;
+        nextBookId = FIRST_BOOK_ID;
+    }
+
+    void enqueueRequest(WaitShard& shard, const IssueRequest& req) {
+        vector<IssueRequest>& waiters = shard.queues[req.bookId];
+        waiters.push_back(req);
+        push_heap(waiters.begin(), waiters.end());
+        waitingCount++;
+    }
+
+    // Replays one logged event on top of the current state
+    bool applyLogRecord(unsigned char type, ByteReader& in) {
+        int bookId = in.getInt32();
+        if (type == LOG_ADD_BOOK) {
+            int copies = in.getInt32();
+            string title = in.getString();
+            string author = in.getString();
+            if (!in.ok() || !in.atEnd() || catalog.findBook(bookId) != nullptr) return false;
+            catalog.addBook(Book(bookId, title, author, copies));
+            if (bookId + 1 > nextBookId) nextBookId = bookId + 1;
+            return true;
+        }
+
+        Book* book = catalog.findBook(bookId);
+        if (book == nullptr) return false;
+        WaitShard& shard = shardFor(bookId);
+
+        if (type == LOG_ISSUED || type == LOG_RETURNED) {
+            if (!in.ok() || !in.atEnd()) return false;
+            book->availableCopies += (type == LOG_ISSUED) ? -1 : 1;
+        } else if (type == LOG_WAITLISTED) {
+            IssueRequest req;
+            req.bookId = bookId;
+            req.priority = in.getInt32();
+            req.sequence = (unsigned long)in.getUint64();
+            req.studentName = in.getString();
+            if (!in.ok() || !in.atEnd()) return false;
+            enqueueRequest(shard, req);
+            if (req.sequence >= nextSequence) nextSequence = req.sequence + 1;
+        } else if (type == LOG_HANDED_OVER) {
+            uint64_t sequence = in.getUint64();
+            unordered_map<int, vector<IssueRequest> >::iterator it = shard.queues.find(bookId);
+            // The heap order is total, so the top is the same request as before the crash
+            if (!in.ok() || !in.atEnd() || it == shard.queues.end() || it->second.front().sequence != sequence) {
+                return false;
+            }
+            pop_heap(it->second.begin(), it->second.end());
+            it->second.pop_back();
+            waitingCount--;
+            if (it->second.empty()) shard.queues.erase(it);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // A crash can leave a copy on the shelf while readers wait (the copy's
+    // issue was never acknowledged); give such copies to the waiters
+    void settleWaiters() {
+        for (int s = 0; s < SHARD_COUNT; s++) {
+            unordered_map<int, vector<IssueRequest> >::iterator it = shards[s].queues.begin();
+            while (it != shards[s].queues.end()) {
+                Book* book = catalog.findBook(it->first);
+                vector<IssueRequest>& waiters = it->second;
+                while (!waiters.empty() && book->availableCopies > 0) {
+                    pop_heap(waiters.begin(), waiters.end());
+                    waiters.pop_back();
+                    book->availableCopies--;
+                    waitingCount--;
+                }
+                if (waiters.empty()) it = shards[s].queues.erase(it);
+                else ++it;
+            }
+        }
+    }
+
+    bool writeSnapshot(const string& path, uint64_t lsn) const {
+        ByteWriter out;
+        out.putByte('L'); out.putByte('B'); out.putByte('S'); out.putByte('N');
+        out.putUint32(1); // Format version
+        out.putUint64(lsn);
+        out.putInt32(nextBookId.load());
+        out.putUint64(nextSequence.load());
+        out.putUint32((uint32_t)catalog.size());
+        catalog.forEachBook([&out](const Book& book) {
+            out.putInt32(book.bookId);
+            out.putInt32(book.totalCopies);
+            out.putInt32(book.availableCopies.load());
+            out.putString(book.title);
+            out.putString(book.author);
+        });
+        out.putUint64(waitingCount.load());
+        for (int s = 0; s < SHARD_COUNT; s++) {
+            for (unordered_map<int, vector<IssueRequest> >::const_iterator it = shards[s].queues.begin();
+                 it != shards[s].queues.end(); ++it) {
+                for (size_t i = 0; i < it->second.size(); i++) {
+                    const IssueRequest& req = it->second[i];
+                    out.putInt32(req.bookId);
+                    out.putInt32(req.priority);
+                    out.putUint64(req.sequence);
+                    out.putString(req.studentName);
+                }
+            }
+        }
+        out.putUint32(checksumOf(out.data().data(), out.data().size()));
+
+        // Written aside and renamed into place, so a crash keeps the old one
+        string tempPath = path + ".tmp";
+        FILE* f = fopen(tempPath.c_str(), "wb");
+        if (f == nullptr) return false;
+        bool ok = fwrite(out.data().data(), 1, out.data().size(), f) == out.data().size() && syncFile(f);
+        ok = (fclose(f) == 0) && ok;
+        if (!ok) {
+            remove(tempPath.c_str());
+            return false;
+        }
+        return replaceFile(tempPath, path) && syncDirectoryOf(path);
+    }
+
+    // Loads a snapshot into this (empty) manager. A missing file is an
+    // empty library at LSN 0; a damaged one is an error.
+    bool loadSnapshot(const string& path, uint64_t& lsn) {
+        lsn = 0;
+        ifstream file(path.c_str(), ios::binary);
+        if (!file) return true;
+        string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+        if (data.size() < 8 || data.compare(0, 4, "LBSN") != 0) return false;
+
+        ByteReader trailer(data.data() + data.size() - 4, 4);
+        if (checksumOf(data.data(), data.size() - 4) != trailer.getUint32()) return false;
+
+        ByteReader in(data.data() + 4, data.size() - 8);
+        if (in.getUint32() != 1) return false;
+        lsn = in.getUint64();
+        nextBookId = in.getInt32();
+        nextSequence = (unsigned long)in.getUint64();
+        uint32_t bookCount = in.getUint32();
+        for (uint32_t i = 0; i < bookCount && in.ok(); i++) {
+            int bookId = in.getInt32();
+            int totalCopies = in.getInt32();
+            int availableCopies = in.getInt32();
+            string title = in.getString();
+            string author = in.getString();
+            Book book(bookId, title, author, totalCopies);
+            book.availableCopies = availableCopies;
+            catalog.addBook(book);
+        }
+        uint64_t requestCount = in.getUint64();
+        for (uint64_t i = 0; i < requestCount && in.ok(); i++) {
+            IssueRequest req;
+            req.bookId = in.getInt32();
+            req.priority = in.getInt32();
+            req.sequence = (unsigned long)in.getUint64();
+            req.studentName = in.getString();
+            if (catalog.findBook(req.bookId) == nullptr) return false;
+            enqueueRequest(shardFor(req.bookId), req);
+        }
+        return in.ok() && in.atEnd() && catalog.size() == bookCount;
+    }
+
+    // The snapshot is synced and renamed into place before the log is
+    // replaced, so a failure at any step leaves the previous snapshot and
+    // log on disk (and the log open) as the state of record
+    bool checkpointAt(uint64_t lsn) {
+        if (!writeSnapshot(storagePath + ".snapshot", lsn)) return false;
+        // Log records up to lsn are now in the snapshot; replay skips them
+        // even if the old log survives a crash right here
+        return wal.create(storagePath + ".wal", lsn + 1);
+    }
 
 public:
-    LibraryManager() : nextBookId(101) {}
+    LibraryManager() : waitingCount(0), nextSequence(0), nextBookId(FIRST_BOOK_ID) {}
 
-    void addBook(const string& title, const string& author, int copies) {
+    // Restores the library from `basePath`.snapshot and `basePath`.wal and
+    // keeps logging every change there. Call once, before anything else.
+    // On failure nothing stays loaded and both files are left as they were.
+    bool openStorage(const string& basePath) {
+        storagePath = basePath;
+        uint64_t lsn = 0;
+        if (!loadSnapshot(basePath + ".snapshot", lsn)) {
+            cout << "❌ Snapshot " << basePath << ".snapshot is damaged; running without storage" << endl;
+            resetState();
+            storagePath.clear();
+            return false;
+        }
+
+        // Only a torn or corrupt tail may end the replay early: a gap or a
+        // whole record that does not fit the state means the files disagree
+        size_t replayed = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        bool intact = WriteAheadLog::replay(basePath + ".wal", [&](uint64_t recordLsn, unsigned char type, ByteReader& in) {
+            if (recordLsn <= lsn) return true;             // Already in the snapshot
+            if (recordLsn != lsn + 1) return false;        // A gap: records are missing
+            if (!applyLogRecord(type, in)) return false;
+            lsn = recordLsn;
+            replayed++;
+            return true;
+        });
+        chrono::steady_clock::time_point end = chrono::steady_clock::now();
+        if (!intact) {
+            cout << "❌ Log " << basePath << ".wal is unreadable, has a gap or a record that does not apply; "
+                 << "running without storage" << endl;
+            resetState();
+            storagePath.clear();
+            return false;
+        }
+
+        settleWaiters();
+        if (!checkpointAt(lsn)) {
+            cout << "❌ Could not write a checkpoint at " << basePath << "; running without storage" << endl;
+            wal.close();
+            resetState();
+            storagePath.clear();
+            return false;
+        }
+        cout << "📂 Restored " << catalog.size() << " book(s), replayed " << replayed << " log record(s) in "
+             << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+        return true;
+    }
+
+    // Once the log has failed no change can be saved, so none is made
+    bool storageBroken() {
+        return !storagePath.empty() && wal.hasFailed();
+    }
+
+    // Folds the log into a new snapshot. Nothing else may run meanwhile.
+    // Refused once the log has failed: the changes it could not save are
+    // still in memory and must not reach the snapshot either.
+    bool checkpoint() {
+        if (storagePath.empty() || storageBroken()) return false;
+        return checkpointAt(wal.lastLsn());
+    }
+
+    size_t bookCount() const {
+        return catalog.size();
+    }
+
+    // Adds a book without any output and returns its ID, or 0 if it could
+    // not be saved. Safe to call while other threads issue and return books.
+    int registerBook(const string& title, const string& author, int copies) {
+        if (storageBroken()) return 0;
         Book book(nextBookId++, title, author, copies);
+        ByteWriter event;
+        event.putInt32(book.bookId);
+        event.putInt32(copies);
+        event.putString(title);
+        event.putString(author);
+        uint64_t lsn = logEvent(LOG_ADD_BOOK, event);
         catalog.addBook(book);
-        cout << "✅ Book added with ID: " << (nextBookId - 1) << endl;
+        return makeDurable(lsn) ? book.bookId : 0;
+    }
+
+    void addBook(const string& title, const string& author, int copies) {
+        int bookId = registerBook(title, author, copies);
+        if (bookId == 0) {
+            cout << "❌ Could not write to the library log; the book was not saved!" << endl;
+            return;
+        }
+        cout << "✅ Book added with ID: " << bookId << endl;
+    }
+
+    const Book* findBook(int bookId) const {
+        return catalog.findBook(bookId);
+    }
+
+    size_t pendingRequests() const {
+        return waitingCount.load();
     }
 
     void displayAllBooks() const {
@@ -30,70 +353,153 @@ public:
         catalog.displayAll();
     }
 
-    void searchBooks(const string& title) const {
-        catalog.searchBooks(title);
+    void searchBooks(const string& query) {
+        catalog.searchBooks(query);
     }
 
-    void issueBook(int bookId, const string& studentName, int priority) {
+    // Thread-safe issue without any output. Taking a free copy is
+    // lock-free; only a reader who has to wait locks the book's shard.
+    CirculationResult checkOut(int bookId, const string& studentName, int priority) {
+        CirculationResult result = {BOOK_NOT_FOUND, string(), 0};
         Book* book = catalog.findBook(bookId);
-        
-        if (book == nullptr) {
-            cout << "❌ Book not found!" << endl;
-            return;
+        if (book == nullptr) return result;
+        if (storageBroken()) {
+            result.status = STORAGE_ERROR;
+            return result;
+        }
+
+        ByteWriter event;
+        event.putInt32(bookId);
+        uint64_t lsn;
+        if (!book->tryTakeCopy()) {
+            WaitShard& shard = shardFor(bookId);
+            unique_lock<mutex> guard(shard.lock);
+            // A return may have put a copy back before the lock was taken;
+            // returns to this book hold the same lock, so none can be missed
+            if (!book->tryTakeCopy()) {
+                IssueRequest req = {studentName, bookId, priority, nextSequence++};
+                event.putInt32(priority);
+                event.putUint64(req.sequence);
+                event.putString(studentName);
+                lsn = logEvent(LOG_WAITLISTED, event);
+                enqueueRequest(shard, req);
+                guard.unlock();
+                result.status = makeDurable(lsn) ? WAITLISTED : STORAGE_ERROR;
+                return result;
+            }
         }
+        // Logged after the copy is taken: the copy's arrival (initial stock
+        // or a return) was logged before it became visible, so replay never
+        // takes a copy that is not there yet
+        lsn = logEvent(LOG_ISSUED, event);
+        result.status = makeDurable(lsn) ? ISSUED : STORAGE_ERROR;
+        result.availableCopies = book->availableCopies.load();
+        return result;
+    }
+
+    // Thread-safe return without any output. The copy goes to the
+    // highest-priority reader waiting for this book in O(log w), if any.
+    CirculationResult checkIn(int bookId) {
+        CirculationResult result = {BOOK_NOT_FOUND, string(), 0};
+        Book* book = catalog.findBook(bookId);
+        if (book == nullptr) return result;
+        if (storageBroken()) {
+            result.status = STORAGE_ERROR;
+            return result;
+        }
+
+        WaitShard& shard = shardFor(bookId);
+        ByteWriter event;
+        event.putInt32(bookId);
+        uint64_t lsn;
+        {
+            lock_guard<mutex> guard(shard.lock);
+            unordered_map<int, vector<IssueRequest> >::iterator it = shard.queues.find(bookId);
+            if (it != shard.queues.end()) {
+                vector<IssueRequest>& waiters = it->second;
+                event.putUint64(waiters.front().sequence);
+                lsn = logEvent(LOG_HANDED_OVER, event);
+                pop_heap(waiters.begin(), waiters.end());
+                result.status = HANDED_OVER;
+                result.servedStudent.swap(waiters.back().studentName);
+                waiters.pop_back();
+                waitingCount--;
+                if (waiters.empty()) shard.queues.erase(it);
+            } else {
+                lsn = logEvent(LOG_RETURNED, event);
+                book->availableCopies++;
+                result.status = RETURNED;
+            }
+        }
+        if (!makeDurable(lsn)) result.status = STORAGE_ERROR;
+        result.availableCopies = book->availableCopies.load();
+        return result;
+    }
+
+    void issueBook(int bookId, const string& studentName, int priority) {
+        CirculationResult result = checkOut(bookId, studentName, priority);
 
-        if (book->availableCopies > 0) {
-            book->availableCopies--;
+        if (result.status == BOOK_NOT_FOUND) {
+            cout << "❌ Book not found!" << endl;
+        } else if (result.status == STORAGE_ERROR) {
+            cout << "❌ Could not write to the library log; the issue was not saved!" << endl;
+        } else if (result.status == ISSUED) {
             cout << "✅ Book issued to " << studentName << endl;
-            cout << "   Remaining copies: " << book->availableCopies << endl;
+            cout << "   Remaining copies: " << result.availableCopies << endl;
         } else {
-            IssueRequest req = {studentName, bookId, priority};
-            requestQueue.push(req);
             cout << "⚠️  No copies available. Added to waiting list with priority " << priority << endl;
         }
     }
 
     void returnBook(int bookId) {
-        Book* book = catalog.findBook(bookId);
-        
-        if (book == nullptr) {
+        CirculationResult result = checkIn(bookId);
+
+        if (result.status == BOOK_NOT_FOUND) {
             cout << "❌ Book not found!" << endl;
             return;
         }
+        if (result.status == STORAGE_ERROR) {
+            cout << "❌ Could not write to the library log; the return was not saved!" << endl;
+            return;
+        }
 
-        book->availableCopies++;
         cout << "✅ Book returned successfully!" << endl;
-
-        // Process waiting requests
-        while (!requestQueue.empty()) {
-            IssueRequest req = requestQueue.top();
-            if (req.bookId == bookId && book->availableCopies > 0) {
-                requestQueue.pop();
-                book->availableCopies--;
-                cout << "📬 Book auto-issued to " << req.studentName 
-                     << " (from waiting list)" << endl;
-                break;
-            } else {
-                break;
-            }
+        if (result.status == HANDED_OVER) {
+            cout << "📬 Book auto-issued to " << result.servedStudent
+                 << " (from waiting list)" << endl;
         }
-
-        cout << "   Available copies: " << book->availableCopies << endl;
+        cout << "   Available copies: " << result.availableCopies << endl;
     }
 
-    void showWaitingList() const {
-        if (requestQueue.empty()) {
+    void showWaitingList() {
+        // Holding every shard (always in index order) keeps the requests
+        // in place while pointers to them are sorted and printed
+        vector<unique_lock<mutex> > locks;
+        for (int s = 0; s < SHARD_COUNT; s++) locks.push_back(unique_lock<mutex>(shards[s].lock));
+
+        if (waitingCount == 0) {
             cout << "\n⚠️  No pending requests!" << endl;
             return;
         }
 
+        // Orders pointers to the requests; the heaps themselves are untouched
+        vector<const IssueRequest*> ordered;
+        ordered.reserve(waitingCount);
+        for (int s = 0; s < SHARD_COUNT; s++) {
+            for (unordered_map<int, vector<IssueRequest> >::const_iterator it = shards[s].queues.begin();
+                 it != shards[s].queues.end(); ++it) {
+                for (size_t i = 0; i < it->second.size(); i++) ordered.push_back(&it->second[i]);
+            }
+        }
+        sort(ordered.begin(), ordered.end(), [](const IssueRequest* a, const IssueRequest* b) {
+            return *b < *a;
+        });
+
         cout << "\n📋 Waiting List (by priority):" << endl;
-        priority_queue<IssueRequest> temp = requestQueue;
         int pos = 1;
-        while (!temp.empty()) {
-            IssueRequest req = temp.top();
-            temp.pop();
-            Book* book = const_cast<LibraryCatalog&>(catalog).findBook(req.bookId);
+        for (size_t i = 0; i < ordered.size(); i++) {
+            const IssueRequest& req = *ordered[i];
+            const Book* book = catalog.findBook(req.bookId);
             cout << "  " << pos++ << ". " << req.studentName 
                  << " waiting for Book ID " << req.bookId;
             if (book) cout << " (" << book->title << ")";
@@ -102,6 +508,63 @@ public:
     }
 };
 
+// Kiosk threads issue and return random books; prints the throughput per
+// thread count and checks that no copy or request was lost
+void runCirculationBenchmark() {
+    const int BOOKS = 1000;
+    const int COPIES = 2;
+    const int OPS_PER_THREAD = 200000;
+
+    unsigned int maxThreads = thread::hardware_concurrency();
+    if (maxThreads == 0) maxThreads = 1;
+
+    cout << "\n⏱️  " << OPS_PER_THREAD << " issue/return pairs per thread over "
+         << BOOKS << " books..." << endl;
+
+    for (unsigned int threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        LibraryManager library;
+        for (int i = 0; i < BOOKS; i++) library.registerBook("Book " + to_string(i), "Author", COPIES);
+
+        atomic<long> handedOver(0);
+        atomic<long> waitlisted(0);
+        vector<thread> kiosks;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (unsigned int t = 0; t < threadCount; t++) {
+            kiosks.push_back(thread([&library, &handedOver, &waitlisted, t]() {
+                mt19937 rng(t + 1);
+                string reader = "Kiosk " + to_string(t);
+                for (int op = 0; op < OPS_PER_THREAD; op++) {
+                    int bookId = 101 + (int)(rng() % BOOKS);
+                    CirculationResult result = library.checkOut(bookId, reader, 1 + (int)(rng() % 3));
+                    if (result.status == WAITLISTED) {
+                        waitlisted++;
+                        continue;
+                    }
+                    if (library.checkIn(bookId).status == HANDED_OVER) handedOver++;
+                }
+            }));
+        }
+        for (size_t t = 0; t < kiosks.size(); t++) kiosks[t].join();
+        chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+        // Every handed-over copy is still out with a waiter; every other
+        // waiter is still queued
+        long copiesOut = 0;
+        for (int i = 0; i < BOOKS; i++) {
+            const Book* book = library.findBook(101 + i);
+            copiesOut += book->totalCopies - book->availableCopies.load();
+        }
+        bool consistent = copiesOut == handedOver.load() &&
+                          (long)library.pendingRequests() == waitlisted.load() - handedOver.load();
+
+        double seconds = chrono::duration<double>(end - start).count();
+        cout << "  " << threadCount << " thread(s): "
+             << (long)(threadCount * (double)OPS_PER_THREAD / seconds) << " pairs/s"
+             << (consistent ? "" : "  ❌ copy counts inconsistent!") << endl;
+    }
+}
+
 int main() {
     LibraryManager library;
 
@@ -109,12 +572,15 @@ int main() {
     cout << "        LIBRARY BOOK MANAGEMENT SYSTEM                  \n";
     cout << "========================================================\n";
 
-    // Add sample books
-    library.addBook("Data Structures and Algorithms", "Cormen", 3);
-    library.addBook("Introduction to Algorithms", "CLRS", 2);
-    library.addBook("C++ Programming", "Bjarne Stroustrup", 4);
-    library.addBook("Operating Systems", "Silberschatz", 2);
-    library.addBook("Computer Networks", "Tanenbaum", 3);
+    // Restore the saved library; a new one starts with sample books
+    library.openStorage("library_data");
+    if (library.bookCount() == 0) {
+        library.addBook("Data Structures and Algorithms", "Cormen", 3);
+        library.addBook("Introduction to Algorithms", "CLRS", 2);
+        library.addBook("C++ Programming", "Bjarne Stroustrup", 4);
+        library.addBook("Operating Systems", "Silberschatz", 2);
+        library.addBook("Computer Networks", "Tanenbaum", 3);
+    }
 
     int choice;
     while (true) {
@@ -124,7 +590,8 @@ int main() {
         cout << "  4. Issue Book\n";
         cout << "  5. Return Book\n";
         cout << "  6. View Waiting List\n";
-        cout << "  7. Exit\n";
+        cout << "  7. Concurrent Circulation Benchmark\n";
+        cout << "  8. Exit\n";
         cout << "  Choice: ";
         cin >> choice;
         cin.ignore();
@@ -144,10 +611,10 @@ int main() {
             library.displayAllBooks();
         }
         else if (choice == 3) {
-            string title;
-            cout << "  Enter title to search: ";
-            getline(cin, title);
-            library.searchBooks(title);
+            string query;
+            cout << "  Search title/author: ";
+            getline(cin, query);
+            library.searchBooks(query);
         }
         else if (choice == 4) {
             int bookId, priority;
@@ -170,6 +637,14 @@ int main() {
             library.showWaitingList();
         }
         else if (choice == 7) {
+            runCirculationBenchmark();
+        }
+        else if (choice == 8) {
+            if (library.storageBroken()) {
+                cout << "❌ The library log could not be written; changes since then were not saved!" << endl;
+            } else {
+                library.checkpoint();
+            }
             cout << "\n  📚 Thank you for using Library Management System!\n";
             break;
         }
@@ -0,0 +1,240 @@
+/*
+ * ============================================================================
+ * DISTANCE FIELD - PRECOMPUTED BFS DISTANCES TO ONE TARGET
+ * ============================================================================
+ * One BFS from the target stores every open cell's distance to it, so
+ * "how far is X from the target" is a single array read and the path is
+ * found by gradient descent: from X keep stepping to a neighbour one step
+ * closer, no search needed.
+ *
+ * When a single wall changes, only the cells whose distance changes are
+ * touched:
+ *   Wall removed  The opened cell takes its best neighbour's distance + 1
+ *                 and the improvement spreads outward breadth first.
+ *   Wall added    Cells that depended on the blocked cell are found in
+ *                 distance order: a cell is affected if none of its
+ *                 neighbours one step closer survives. Their distances are
+ *                 cleared and recomputed Dijkstra-style, seeded from the
+ *                 unaffected cells around them.
+ *
+ * Costs 4 bytes per cell while built; invalidate() gives the memory back.
+ * ============================================================================
+ */
+
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include "MazeGrid.h"
+#include <vector>
+#include <queue>
+#include <functional>
+#include <utility>
+#include <cstdint>
+using namespace std;
+
+// Distance of walls and of cells cut off from the target
+const uint32_t UNREACHABLE = UINT32_MAX;
+
+class DistanceField {
+private:
+    vector<uint32_t> distance; // Steps to the target; UNREACHABLE for walls and cut-off cells
+    Point target;
+    bool ready;
+
+    typedef pair<uint32_t, uint32_t> QueueEntry; // (distance, cell)
+
+    // Smallest neighbour distance + 1 (target: 0)
+    uint32_t bestThroughNeighbours(const MazeGrid& grid, Point p) const {
+        if (p == target) return 0;
+        uint32_t best = UNREACHABLE;
+        for (int i = 0; i < 4; i++) {
+            int r = p.row + DIR_ROW[i];
+            int c = p.col + DIR_COL[i];
+            if (!grid.isOpen(r, c)) continue;
+            uint32_t d = distance[grid.indexOf(r, c)];
+            if (d != UNREACHABLE && d + 1 < best) best = d + 1;
+        }
+        return best;
+    }
+
+    // Lowers distances outward from cells whose distance just dropped;
+    // returns how many cells were lowered
+    size_t spreadDecrease(const MazeGrid& grid, queue<uint32_t>& pending) {
+        size_t lowered = 0;
+        while (!pending.empty()) {
+            uint32_t cell = pending.front();
+            pending.pop();
+            Point p = grid.pointOf(cell);
+            for (int i = 0; i < 4; i++) {
+                int r = p.row + DIR_ROW[i];
+                int c = p.col + DIR_COL[i];
+                if (!grid.isOpen(r, c)) continue;
+                size_t next = grid.indexOf(r, c);
+                if (distance[cell] + 1 < distance[next]) {
+                    distance[next] = distance[cell] + 1;
+                    pending.push((uint32_t)next);
+                    lowered++;
+                }
+            }
+        }
+        return lowered;
+    }
+
+public:
+    DistanceField() : ready(false) {}
+
+    bool isReady() const { return ready; }
+    Point targetPoint() const { return target; }
+
+    void invalidate() {
+        ready = false;
+        vector<uint32_t>().swap(distance);
+    }
+
+    size_t memoryBytes() const {
+        return distance.size() * sizeof(uint32_t);
+    }
+
+    // Full BFS from the target
+    void build(const MazeGrid& grid, Point goal) {
+        target = goal;
+        distance.assign(grid.cellCount(), UNREACHABLE);
+        ready = true;
+        if (!grid.isOpen(goal.row, goal.col)) return;
+
+        vector<uint32_t> frontier, next;
+        frontier.push_back((uint32_t)grid.indexOf(goal.row, goal.col));
+        distance[frontier[0]] = 0;
+        for (uint32_t level = 1; !frontier.empty(); level++) {
+            for (size_t k = 0; k < frontier.size(); k++) {
+                Point p = grid.pointOf(frontier[k]);
+                for (int i = 0; i < 4; i++) {
+                    int r = p.row + DIR_ROW[i];
+                    int c = p.col + DIR_COL[i];
+                    if (!grid.isOpen(r, c)) continue;
+                    size_t cell = grid.indexOf(r, c);
+                    if (distance[cell] == UNREACHABLE) {
+                        distance[cell] = level;
+                        next.push_back((uint32_t)cell);
+                    }
+                }
+            }
+            frontier.swap(next);
+            next.clear();
+        }
+    }
+
+    // Steps from p to the target, or UNREACHABLE
+    uint32_t distanceFrom(const MazeGrid& grid, Point p) const {
+        if (!ready || !grid.inBounds(p.row, p.col)) return UNREACHABLE;
+        return distance[grid.indexOf(p.row, p.col)];
+    }
+
+    // Fills path from `from` to the target by always stepping downhill;
+    // false if the target cannot be reached
+    bool pathFrom(const MazeGrid& grid, Point from, vector<Point>& path) const {
+        path.clear();
+        uint32_t d = distanceFrom(grid, from);
+        if (d == UNREACHABLE) return false;
+
+        Point p = from;
+        path.push_back(p);
+        while (d > 0) {
+            for (int i = 0; i < 4; i++) {
+                int r = p.row + DIR_ROW[i];
+                int c = p.col + DIR_COL[i];
+                if (grid.isOpen(r, c) && distance[grid.indexOf(r, c)] == d - 1) {
+                    p = Point(r, c);
+                    break;
+                }
+            }
+            path.push_back(p);
+            d--;
+        }
+        return true;
+    }
+
+    // Call after the grid has opened this cell. Returns the cells updated.
+    size_t wallRemoved(const MazeGrid& grid, Point cell) {
+        if (!ready) return 0;
+        size_t index = grid.indexOf(cell.row, cell.col);
+        uint32_t best = bestThroughNeighbours(grid, cell);
+        if (best == UNREACHABLE) return 0; // Opened into a region cut off from the target
+
+        distance[index] = best;
+        queue<uint32_t> pending;
+        pending.push((uint32_t)index);
+        return 1 + spreadDecrease(grid, pending);
+    }
+
+    // Call after the grid has walled off this cell. Returns the cells
+    // whose distance had to be recomputed.
+    size_t wallAdded(const MazeGrid& grid, Point cell) {
+        if (!ready) return 0;
+        size_t index = grid.indexOf(cell.row, cell.col);
+        if (cell == target) {
+            build(grid, target); // Nothing can reach a walled-in target
+            return grid.cellCount();
+        }
+        uint32_t old = distance[index];
+        distance[index] = UNREACHABLE;
+        if (old == UNREACHABLE) return 0;
+
+        // Find the affected cells, nearest first. By the time a cell at
+        // distance k is checked, every cell at k - 1 has been decided.
+        vector<uint32_t> affected;
+        queue<uint32_t> candidates;
+        candidates.push((uint32_t)index);
+        while (!candidates.empty()) {
+            uint32_t lost = candidates.front();
+            candidates.pop();
+            Point p = grid.pointOf(lost);
+            for (int i = 0; i < 4; i++) {
+                int r = p.row + DIR_ROW[i];
+                int c = p.col + DIR_COL[i];
+                if (!grid.isOpen(r, c)) continue;
+                size_t next = grid.indexOf(r, c);
+                uint32_t d = distance[next];
+                if (d == UNREACHABLE || d == 0) continue;
+                if (bestThroughNeighbours(grid, Point(r, c)) == d) continue; // Still supported
+
+                distance[next] = UNREACHABLE;
+                affected.push_back((uint32_t)next);
+                candidates.push((uint32_t)next);
+            }
+        }
+
+        // Re-settle the affected cells from their unaffected borders. Seeds
+        // are all taken before any is written, so each comes from a final
+        // distance.
+        vector<QueueEntry> seeds;
+        for (size_t k = 0; k < affected.size(); k++) {
+            uint32_t best = bestThroughNeighbours(grid, grid.pointOf(affected[k]));
+            if (best != UNREACHABLE) seeds.push_back(QueueEntry(best, affected[k]));
+        }
+        priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry> > open;
+        for (size_t k = 0; k < seeds.size(); k++) {
+            distance[seeds[k].second] = seeds[k].first;
+            open.push(seeds[k]);
+        }
+        while (!open.empty()) {
+            QueueEntry entry = open.top();
+            open.pop();
+            if (entry.first != distance[entry.second]) continue; // Improved since
+            Point p = grid.pointOf(entry.second);
+            for (int i = 0; i < 4; i++) {
+                int r = p.row + DIR_ROW[i];
+                int c = p.col + DIR_COL[i];
+                if (!grid.isOpen(r, c)) continue;
+                size_t next = grid.indexOf(r, c);
+                if (entry.first + 1 < distance[next]) {
+                    distance[next] = entry.first + 1;
+                    open.push(QueueEntry(entry.first + 1, (uint32_t)next));
+                }
+            }
+        }
+        return affected.size() + 1; // Plus the blocked cell itself
+    }
+};
+
+#endif
@@ -0,0 +1,330 @@
+/*
+ * ============================================================================
+ * MAZE GENERATORS - KRUSKAL, RECURSIVE BACKTRACKER, WILSON
+ * ============================================================================
+ * Each builds a perfect maze (exactly one path between any two rooms), so
+ * every maze is solvable. Rooms sit on even rows and columns; the cells
+ * between two rooms are carved into passages, and everything else stays
+ * wall. Start is room (0, 0) and end is the last room (lastRoom()).
+ *
+ * Kruskal      Knocks down the walls between rooms in random order,
+ *              skipping any wall whose rooms are already connected
+ *              (disjoint-set with path compression and union by rank).
+ * Backtracker  Depth-first carving with an explicit stack, so maze size
+ *              is not limited by the call stack. Long, winding corridors.
+ * Wilson       Loop-erased random walks from each room until the walk hits
+ *              the maze built so far. Picks uniformly among all perfect
+ *              mazes; slowest of the three.
+ *
+ * The same seed always gives the same maze. Xoshiro256 is the generator
+ * used by the playlist manager's shuffle.
+ * ============================================================================
+ */
+
+#ifndef MAZE_GENERATORS_H
+#define MAZE_GENERATORS_H
+
+#include "MazeGrid.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+using namespace std;
+
+class Xoshiro256 {
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+    explicit Xoshiro256(uint64_t seed = 0x9E3779B97F4A7C15ULL) {
+        reseed(seed);
+    }
+
+    // Expands one seed into the full state with splitmix64
+    void reseed(uint64_t seed) {
+        for (int i = 0; i < 4; i++) {
+            seed += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            state[i] = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform integer in [0, bound) without modulo bias
+    uint64_t nextBelow(uint64_t bound) {
+        uint64_t threshold = (0 - bound) % bound;
+        while (true) {
+            uint64_t r = next();
+            if (r >= threshold) return r % bound;
+        }
+    }
+};
+
+// Hints that an address will be read soon; a no-op where unsupported
+inline void prefetch(const void* address) {
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+class DisjointSet {
+private:
+    // parent[x] >= 0: x's parent. parent[x] < 0: x is a root of rank
+    // -parent[x] - 1. One array, so a find touches one cache line per step.
+    vector<int32_t> parent;
+
+public:
+    explicit DisjointSet(size_t count = 0) {
+        reset(count);
+    }
+
+    void reset(size_t count) {
+        parent.assign(count, -1);
+    }
+
+    uint32_t find(uint32_t x) {
+        uint32_t root = x;
+        while (parent[root] >= 0) root = parent[root];
+        // Path compression: point everything on the way straight at the root
+        while (parent[x] >= 0 && (uint32_t)parent[x] != root) {
+            uint32_t next = parent[x];
+            parent[x] = (int32_t)root;
+            x = next;
+        }
+        return root;
+    }
+
+    // False if a and b were already in the same set
+    bool unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (parent[a] > parent[b]) swap(a, b); // Union by rank: a is the taller tree
+        if (parent[a] == parent[b]) parent[a]--;
+        parent[b] = (int32_t)a;
+        return true;
+    }
+
+    void prefetchElement(uint32_t x) const {
+        prefetch(&parent[x]);
+    }
+};
+
+enum MazeAlgorithm {
+    KRUSKAL = 1,
+    BACKTRACKER,
+    WILSON
+};
+
+class MazeGenerator {
+private:
+    Xoshiro256 rng;
+    uint64_t directionBits; // Unused random bits, two per direction
+    int directionsLeft;
+    int roomRows, roomCols;
+
+    static const uint32_t LOOKAHEAD = 8;
+
+    // Rooms are numbered row by row on the half-resolution room grid
+    Point cellOf(uint32_t room) const {
+        return Point(2 * (int)(room / roomCols), 2 * (int)(room % roomCols));
+    }
+
+    // Neighbouring room in direction d, or false at the edge
+    bool neighbour(uint32_t room, int d, uint32_t& next) const {
+        int r = (int)(room / roomCols) + DIR_ROW[d];
+        int c = (int)(room % roomCols) + DIR_COL[d];
+        if (r < 0 || r >= roomRows || c < 0 || c >= roomCols) return false;
+        next = (uint32_t)r * roomCols + c;
+        return true;
+    }
+
+    bool isCarved(const MazeGrid& grid, uint32_t room) const {
+        Point p = cellOf(room);
+        return !grid.isWall(p.row, p.col);
+    }
+
+    void carveRoom(MazeGrid& grid, uint32_t room) {
+        Point p = cellOf(room);
+        grid.setWall(p.row, p.col, false);
+    }
+
+    // Opens the passage leaving room in direction d
+    void carvePassage(MazeGrid& grid, uint32_t room, int d) {
+        Point p = cellOf(room);
+        grid.setWall(p.row + DIR_ROW[d], p.col + DIR_COL[d], false);
+    }
+
+    // Room left of (or above) a wall in kruskal()'s numbering
+    uint32_t roomBeside(uint32_t wall, uint32_t horizontalWalls) const {
+        if (wall < horizontalWalls) return wall / (roomCols - 1) * roomCols + wall % (roomCols - 1);
+        return wall - horizontalWalls;
+    }
+
+    // Fisher-Yates, drawing each swap partner LOOKAHEAD steps early so
+    // its slot can be prefetched
+    void shuffle(vector<uint32_t>& values) {
+        uint32_t count = (uint32_t)values.size();
+        uint32_t pending[LOOKAHEAD];
+        for (uint32_t i = 0; i < LOOKAHEAD && i + 1 < count; i++) {
+            pending[i] = (uint32_t)rng.nextBelow(count - i);
+            prefetch(&values[pending[i]]);
+        }
+        for (uint32_t k = count; k > 1; k--) {
+            uint32_t slot = (count - k) % LOOKAHEAD;
+            swap(values[k - 1], values[pending[slot]]);
+            if (k > LOOKAHEAD + 1) {
+                pending[slot] = (uint32_t)rng.nextBelow(k - LOOKAHEAD);
+                prefetch(&values[pending[slot]]);
+            }
+        }
+    }
+
+    int randomDirection() {
+        if (directionsLeft == 0) {
+            directionBits = rng.next();
+            directionsLeft = 32;
+        }
+        int d = (int)(directionBits & 3);
+        directionBits >>= 2;
+        directionsLeft--;
+        return d;
+    }
+
+    // Fills the grid with wall and sizes the room grid
+    uint32_t prepare(MazeGrid& grid) {
+        roomRows = (grid.rows() + 1) / 2;
+        roomCols = (grid.cols() + 1) / 2;
+        grid.fill(true);
+        return (uint32_t)roomRows * roomCols;
+    }
+
+public:
+    explicit MazeGenerator(uint64_t seed) : rng(seed), directionBits(0), directionsLeft(0), roomRows(0), roomCols(0) {}
+
+    static Point lastRoom(const MazeGrid& grid) {
+        return Point((grid.rows() - 1) & ~1, (grid.cols() - 1) & ~1);
+    }
+
+    void generate(MazeGrid& grid, MazeAlgorithm algorithm) {
+        if (algorithm == KRUSKAL) kruskal(grid);
+        else if (algorithm == BACKTRACKER) backtracker(grid);
+        else wilson(grid);
+    }
+
+    void kruskal(MazeGrid& grid) {
+        uint32_t rooms = prepare(grid);
+        for (uint32_t room = 0; room < rooms; room++) carveRoom(grid, room);
+
+        // Wall k < horizontalWalls sits right of room k's slot in its row;
+        // the rest sit below rooms 0, 1, 2, ...
+        uint32_t horizontalWalls = (uint32_t)roomRows * (roomCols - 1);
+        uint32_t wallCount = horizontalWalls + (uint32_t)(roomRows - 1) * roomCols;
+        vector<uint32_t> walls(wallCount);
+        for (uint32_t k = 0; k < wallCount; k++) walls[k] = k;
+        shuffle(walls);
+
+        DisjointSet sets(rooms);
+        uint32_t joined = 1;
+        for (uint32_t k = 0; k < wallCount && joined < rooms; k++) {
+            // The order is known, so start fetching the sets a few walls
+            // ahead; on big mazes nearly every find is a cache miss
+            if (k + LOOKAHEAD < wallCount) {
+                uint32_t upcoming = walls[k + LOOKAHEAD];
+                uint32_t room = roomBeside(upcoming, horizontalWalls);
+                sets.prefetchElement(room);
+                sets.prefetchElement(upcoming < horizontalWalls ? room + 1 : room + roomCols);
+            }
+
+            uint32_t wall = walls[k];
+            uint32_t room = roomBeside(wall, horizontalWalls);
+            int d = wall < horizontalWalls ? 1 : 2; // Right or down
+            uint32_t other = d == 1 ? room + 1 : room + roomCols;
+            if (sets.unite(room, other)) {
+                carvePassage(grid, room, d);
+                joined++;
+            }
+        }
+    }
+
+    void backtracker(MazeGrid& grid) {
+        prepare(grid);
+        vector<uint32_t> path; // Rooms from the start to the current one
+        path.push_back(0);
+        carveRoom(grid, 0);
+
+        while (!path.empty()) {
+            uint32_t room = path.back();
+            int options[4];
+            uint32_t targets[4];
+            int count = 0;
+            for (int d = 0; d < 4; d++) {
+                uint32_t next;
+                if (neighbour(room, d, next) && !isCarved(grid, next)) {
+                    options[count] = d;
+                    targets[count++] = next;
+                }
+            }
+            if (count == 0) {
+                path.pop_back(); // Dead end: back up
+                continue;
+            }
+            int pick = (int)rng.nextBelow(count);
+            carvePassage(grid, room, options[pick]);
+            carveRoom(grid, targets[pick]);
+            path.push_back(targets[pick]);
+        }
+    }
+
+    void wilson(MazeGrid& grid) {
+        uint32_t rooms = prepare(grid);
+        vector<uint8_t> exitDirection(rooms); // Last move made from each room on the current walk
+        carveRoom(grid, (uint32_t)rng.nextBelow(rooms));
+
+        for (uint32_t origin = 0; origin < rooms; origin++) {
+            if (isCarved(grid, origin)) continue;
+
+            // Random walk until the maze is hit. Revisiting a room
+            // overwrites its exit, which erases the loop just made.
+            uint32_t room = origin;
+            while (!isCarved(grid, room)) {
+                uint32_t next;
+                int d;
+                do {
+                    d = randomDirection();
+                } while (!neighbour(room, d, next));
+                exitDirection[room] = (uint8_t)d;
+                room = next;
+            }
+
+            // Carve the loop-erased walk into the maze
+            room = origin;
+            while (!isCarved(grid, room)) {
+                int d = exitDirection[room];
+                carveRoom(grid, room);
+                carvePassage(grid, room, d);
+                neighbour(room, d, room);
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ * ============================================================================
+ * MAZE GRID - RUNTIME-SIZED, BIT-PACKED WALL MAP + GENERATION-STAMPED MARKS
+ * ============================================================================
+ * MazeGrid     One bit per cell (1 = wall), rows of any size chosen at run
+ *              time. Cells are numbered row by row (index = row * cols +
+ *              col), so a 10k x 10k map is 100M bits = 12.5 MB.
+ * VisitedMarks One byte per cell for searches: a 6-bit generation stamp
+ *              and the 2-bit direction the cell was entered from. A cell
+ *              counts as visited only if its stamp equals the current
+ *              generation, so reset() usually just bumps the generation.
+ *              When the stamps run out the whole array is cleared: every
+ *              63 one-sided searches, or every 31 searches from both ends,
+ *              which take two consecutive generations, one per side. A
+ *              reset therefore still costs cells / 63 writes on average
+ *              (cells / 31 for two-sided searches): about 1.6 MB (3.2 MB)
+ *              per search on a 10k x 10k map, whose marks take 100 MB. In
+ *              exchange a single array serves every solver of a maze.
+ * ============================================================================
+ */
+
+#ifndef MAZE_GRID_H
+#define MAZE_GRID_H
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+struct Point {
+    int row, col;
+    Point(int r = 0, int c = 0) : row(r), col(c) {}
+    bool operator==(const Point& other) const {
+        return row == other.row && col == other.col;
+    }
+};
+
+// Direction vectors: Up, Right, Down, Left; (d + 2) % 4 is the opposite
+const int DIR_ROW[4] = {-1, 0, 1, 0};
+const int DIR_COL[4] = {0, 1, 0, -1};
+
+class MazeGrid {
+private:
+    int rowCount;
+    int colCount;
+    vector<uint64_t> wallBits;
+
+public:
+    MazeGrid(int rows = 0, int cols = 0) : rowCount(0), colCount(0) {
+        resize(rows, cols);
+    }
+
+    // Discards the old contents; every cell starts open
+    void resize(int rows, int cols) {
+        rowCount = rows;
+        colCount = cols;
+        wallBits.assign((cellCount() + 63) / 64, 0);
+    }
+
+    int rows() const { return rowCount; }
+    int cols() const { return colCount; }
+    size_t cellCount() const { return (size_t)rowCount * colCount; }
+
+    bool inBounds(int r, int c) const {
+        return r >= 0 && r < rowCount && c >= 0 && c < colCount;
+    }
+
+    size_t indexOf(int r, int c) const { return (size_t)r * colCount + c; }
+    Point pointOf(size_t index) const { return Point((int)(index / colCount), (int)(index % colCount)); }
+
+    bool isWallAt(size_t index) const {
+        return (wallBits[index >> 6] >> (index & 63)) & 1;
+    }
+
+    bool isWall(int r, int c) const {
+        return isWallAt(indexOf(r, c));
+    }
+
+    // In bounds and not a wall
+    bool isOpen(int r, int c) const {
+        return inBounds(r, c) && !isWall(r, c);
+    }
+
+    void setWallAt(size_t index, bool wall) {
+        uint64_t bit = (uint64_t)1 << (index & 63);
+        if (wall) wallBits[index >> 6] |= bit;
+        else wallBits[index >> 6] &= ~bit;
+    }
+
+    void setWall(int r, int c, bool wall) {
+        setWallAt(indexOf(r, c), wall);
+    }
+
+    void fill(bool wall) {
+        std::fill(wallBits.begin(), wallBits.end(), wall ? ~(uint64_t)0 : 0);
+    }
+
+    size_t memoryBytes() const {
+        return wallBits.size() * sizeof(uint64_t);
+    }
+};
+
+class VisitedMarks {
+private:
+    vector<uint8_t> marks; // (stamp << 2) | entry direction
+    uint8_t generation;    // 1..63; 0 never matches, so a cleared array is all unvisited
+    uint8_t sideCount;     // Generations the current search uses: side s stamps generation + s
+
+    static const int MAX_GENERATION = 63;
+
+public:
+    VisitedMarks() : generation(1), sideCount(1) {}
+
+    void resize(size_t cells) {
+        marks.assign(cells, 0);
+        generation = 1;
+        sideCount = 1;
+    }
+
+    // Sizes the marks for a grid of this many cells and starts a search
+    // with `sides` independent sets of marks (1, or 2 for a search from
+    // both ends)
+    void prepare(size_t cells, int sides = 1) {
+        if (marks.size() != cells) resize(cells);
+        reset(sides);
+    }
+
+    // Forgets every visit. Usually O(1), but one call in ~63 (~31 when
+    // sides is 2) clears the whole array, so the amortized cost is
+    // O(cells / 63), not O(1).
+    void reset(int sides = 1) {
+        int next = generation + sideCount;
+        if (next + sides - 1 > MAX_GENERATION) {
+            std::fill(marks.begin(), marks.end(), 0);
+            next = 1;
+        }
+        generation = (uint8_t)next;
+        sideCount = (uint8_t)sides;
+    }
+
+    bool isVisited(size_t index, int side = 0) const {
+        return (marks[index] >> 2) == generation + side;
+    }
+
+    // direction = the move (index into DIR_ROW/DIR_COL) that reached the
+    // cell. A cell holds one mark, so visiting it for one side removes it
+    // from the other.
+    void visit(size_t index, int direction, int side = 0) {
+        marks[index] = (uint8_t)(((generation + side) << 2) | direction);
+    }
+
+    int direction(size_t index) const {
+        return marks[index] & 3;
+    }
+
+    size_t memoryBytes() const {
+        return marks.size();
+    }
+};
+
+// Appends the cells from `from` back to `root` by undoing the entry
+// direction stored for each one
+inline void traceBack(const MazeGrid& grid, const VisitedMarks& marks, Point from, Point root, vector<Point>& out) {
+    Point p = from;
+    out.push_back(p);
+    while (!(p == root)) {
+        int d = marks.direction(grid.indexOf(p.row, p.col));
+        p = Point(p.row - DIR_ROW[d], p.col - DIR_COL[d]);
+        out.push_back(p);
+    }
+}
+
+#endif
@@ -0,0 +1,478 @@
+/*
+ * ============================================================================
+ * MAZE SOLVERS - A*, BIDIRECTIONAL BFS, JUMP POINT SEARCH
+ * ============================================================================
+ * All three (A*, bidirectional BFS and Jump Point Search) find shortest
+ * 4-connected paths and fill in SolveStats (cells expanded, wall time) so
+ * solvers can be compared on the same map. The caller lends each search
+ * its VisitedMarks, so one byte per cell serves every solver of a maze,
+ * and each solver keeps its queues between calls, so repeated solves on
+ * one maze allocate nothing.
+ *
+ * AStarSolver       Manhattan heuristic. With unit moves f = g + h either
+ *                   stays the same (a step towards the goal) or grows by 2
+ *                   (a step away), so the open list only ever holds two f
+ *                   values: a bucket queue with two buckets. Within a
+ *                   bucket the newest entry comes out first, which favours
+ *                   the deepest cells and breaks ties towards the goal.
+ * BidirectionalBFS  Searches from both ends a whole level at a time,
+ *                   always growing the smaller frontier. The first cell
+ *                   reached from both sides lies on a shortest path.
+ * JumpPointSolver   A* over jump points only (4-connected JPS). A move
+ *                   continues in a straight line past every cell that
+ *                   offers nothing new and stops at the goal, a wall, or a
+ *                   cell with a forced neighbour (a side cell that cannot
+ *                   be reached as cheaply any other way). Vertical moves
+ *                   also stop where a horizontal jump would find
+ *                   something, playing the role diagonals play in 8-way
+ *                   JPS. Open floors collapse to a handful of expansions.
+ *                   With JPS+ tables (signed 16-bit distance to the next
+ *                   jump point or wall, per cell and direction, built once
+ *                   per maze) each jump is O(1) instead of a scan.
+ * ============================================================================
+ */
+
+#ifndef MAZE_SOLVERS_H
+#define MAZE_SOLVERS_H
+
+#include "MazeGrid.h"
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+#include <cstdlib>
+#include <cstdint>
+using namespace std;
+
+struct SolveStats {
+    size_t expanded;     // Cells whose neighbours were examined
+    double milliseconds; // Wall time of the search, including path tracing
+
+    SolveStats() : expanded(0), milliseconds(0) {}
+};
+
+class SolveTimer {
+private:
+    chrono::steady_clock::time_point started;
+
+public:
+    SolveTimer() : started(chrono::steady_clock::now()) {}
+
+    double elapsedMs() const {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+    }
+};
+
+inline int manhattan(Point a, Point b) {
+    return abs(a.row - b.row) + abs(a.col - b.col);
+}
+
+class AStarSolver {
+private:
+    struct OpenEntry {
+        uint32_t cell;
+        uint8_t direction; // Move that reached the cell
+    };
+
+    vector<OpenEntry> currentBucket; // f == current bound
+    vector<OpenEntry> nextBucket;    // f == current bound + 2
+
+public:
+    // Fills path from start to end; false if end is unreachable. `closed`
+    // is reset and used as the closed set.
+    bool solve(const MazeGrid& grid, VisitedMarks& closed, Point start, Point end, vector<Point>& path,
+               SolveStats& stats) {
+        SolveTimer timer;
+        stats = SolveStats();
+        path.clear();
+        closed.prepare(grid.cellCount());
+        currentBucket.clear();
+        nextBucket.clear();
+
+        size_t target = grid.indexOf(end.row, end.col);
+        OpenEntry first = {(uint32_t)grid.indexOf(start.row, start.col), 0};
+        if (!grid.isWallAt(first.cell)) currentBucket.push_back(first);
+
+        bool found = false;
+        while (!currentBucket.empty() || !nextBucket.empty()) {
+            if (currentBucket.empty()) {
+                currentBucket.swap(nextBucket);
+                continue;
+            }
+            OpenEntry entry = currentBucket.back();
+            currentBucket.pop_back();
+            if (closed.isVisited(entry.cell)) continue; // Reached more cheaply already
+
+            // The heuristic is consistent, so the first time a cell is
+            // taken off the open list its cost is final
+            closed.visit(entry.cell, entry.direction);
+            stats.expanded++;
+            if (entry.cell == target) {
+                found = true;
+                break;
+            }
+
+            Point curr = grid.pointOf(entry.cell);
+            int h = manhattan(curr, end);
+            for (int i = 0; i < 4; i++) {
+                int newR = curr.row + DIR_ROW[i];
+                int newC = curr.col + DIR_COL[i];
+                if (!grid.isOpen(newR, newC)) continue;
+
+                OpenEntry next = {(uint32_t)grid.indexOf(newR, newC), (uint8_t)i};
+                if (closed.isVisited(next.cell)) continue;
+                if (manhattan(Point(newR, newC), end) < h) currentBucket.push_back(next);
+                else nextBucket.push_back(next);
+            }
+        }
+
+        if (found) {
+            traceBack(grid, closed, end, start, path);
+            reverse(path.begin(), path.end());
+        }
+        stats.milliseconds = timer.elapsedMs();
+        return found;
+    }
+};
+
+class BidirectionalBFS {
+private:
+    vector<uint32_t> startFrontier, endFrontier, next;
+
+    static const uint32_t NO_CELL = UINT32_MAX;
+    static const int START_SIDE = 0;
+    static const int END_SIDE = 1;
+
+    // Expands one whole level of one side. When a neighbour turns out to
+    // be the other side's already, returns it (keeping the other side's
+    // mark) and sets `reachedFrom` to this side's cell next to it;
+    // otherwise returns NO_CELL.
+    uint32_t expandLevel(const MazeGrid& grid, vector<uint32_t>& frontier, VisitedMarks& marks, int side,
+                         uint32_t& reachedFrom, SolveStats& stats) {
+        next.clear();
+        for (size_t k = 0; k < frontier.size(); k++) {
+            stats.expanded++;
+            Point curr = grid.pointOf(frontier[k]);
+            for (int i = 0; i < 4; i++) {
+                int newR = curr.row + DIR_ROW[i];
+                int newC = curr.col + DIR_COL[i];
+                if (!grid.isOpen(newR, newC)) continue;
+
+                size_t index = grid.indexOf(newR, newC);
+                if (marks.isVisited(index, side)) continue;
+                if (marks.isVisited(index, 1 - side)) {
+                    reachedFrom = frontier[k];
+                    return (uint32_t)index;
+                }
+                marks.visit(index, i, side);
+                next.push_back((uint32_t)index);
+            }
+        }
+        frontier.swap(next);
+        return NO_CELL;
+    }
+
+public:
+    // Fills path from start to end; false if end is unreachable. `marks`
+    // is reset and holds both searches.
+    bool solve(const MazeGrid& grid, VisitedMarks& marks, Point start, Point end, vector<Point>& path,
+               SolveStats& stats) {
+        SolveTimer timer;
+        stats = SolveStats();
+        path.clear();
+        marks.prepare(grid.cellCount(), 2);
+        startFrontier.clear();
+        endFrontier.clear();
+
+        size_t startCell = grid.indexOf(start.row, start.col);
+        size_t endCell = grid.indexOf(end.row, end.col);
+        if (grid.isWallAt(startCell) || grid.isWallAt(endCell)) {
+            stats.milliseconds = timer.elapsedMs();
+            return false;
+        }
+
+        if (startCell == endCell) {
+            path.push_back(start);
+            stats.milliseconds = timer.elapsedMs();
+            return true;
+        }
+
+        marks.visit(startCell, 0, START_SIDE);
+        marks.visit(endCell, 0, END_SIDE);
+        startFrontier.push_back((uint32_t)startCell);
+        endFrontier.push_back((uint32_t)endCell);
+
+        // The two sides touch across the edge between lastOfStart and
+        // firstOfEnd
+        uint32_t lastOfStart = NO_CELL, firstOfEnd = NO_CELL;
+        while (lastOfStart == NO_CELL && !startFrontier.empty() && !endFrontier.empty()) {
+            uint32_t from;
+            if (startFrontier.size() <= endFrontier.size()) {
+                firstOfEnd = expandLevel(grid, startFrontier, marks, START_SIDE, from, stats);
+                if (firstOfEnd != NO_CELL) lastOfStart = from;
+            } else {
+                lastOfStart = expandLevel(grid, endFrontier, marks, END_SIDE, from, stats);
+                if (lastOfStart != NO_CELL) firstOfEnd = from;
+            }
+        }
+
+        if (lastOfStart != NO_CELL) {
+            traceBack(grid, marks, grid.pointOf(lastOfStart), start, path);
+            reverse(path.begin(), path.end());
+            traceBack(grid, marks, grid.pointOf(firstOfEnd), end, path);
+        }
+        stats.milliseconds = timer.elapsedMs();
+        return lastOfStart != NO_CELL;
+    }
+};
+
+class JumpPointSolver {
+private:
+    struct JumpNode {
+        uint32_t g;         // Path length from start
+        uint32_t parent;    // Previous jump point (start is its own parent)
+        uint8_t direction;  // Direction of the segment that arrives here; 4 = start
+    };
+
+    struct OpenItem {
+        uint32_t f, g, cell;
+
+        // Heap order: smallest f first, then the deepest
+        bool operator<(const OpenItem& other) const {
+            return f != other.f ? f > other.f : g < other.g;
+        }
+    };
+
+    unordered_map<uint32_t, JumpNode> nodes;
+    vector<OpenItem> open;
+
+    // jumpTable[d][cell] describes the straight run starting next to cell
+    // in direction d: k > 0 = first jump point k steps away; -w = w open
+    // cells, then a wall or the edge. The goal is checked at query time.
+    vector<int16_t> jumpTable[4];
+    bool tablesReady;
+
+    static const uint32_t NO_CELL = UINT32_MAX;
+
+    // Moving horizontally by dc into (r, c): a cell above or below that the
+    // previous cell could not step to from its own side
+    static bool forcedHorizontal(const MazeGrid& grid, int r, int c, int dc) {
+        return (grid.isOpen(r - 1, c) && !grid.isOpen(r - 1, c - dc)) ||
+               (grid.isOpen(r + 1, c) && !grid.isOpen(r + 1, c - dc));
+    }
+
+    static bool forcedVertical(const MazeGrid& grid, int r, int c, int dr) {
+        return (grid.isOpen(r, c - 1) && !grid.isOpen(r - dr, c - 1)) ||
+               (grid.isOpen(r, c + 1) && !grid.isOpen(r - dr, c + 1));
+    }
+
+    // Scans from (r, c) onwards; (r, c) is the first cell tested
+    uint32_t scanHorizontal(const MazeGrid& grid, int r, int c, int dc, Point end) const {
+        for (;; c += dc) {
+            if (!grid.isOpen(r, c)) return NO_CELL;
+            if (r == end.row && c == end.col) return (uint32_t)grid.indexOf(r, c);
+            if (forcedHorizontal(grid, r, c, dc)) return (uint32_t)grid.indexOf(r, c);
+        }
+    }
+
+    uint32_t scanVertical(const MazeGrid& grid, int r, int c, int dr, Point end) const {
+        for (;; r += dr) {
+            if (!grid.isOpen(r, c)) return NO_CELL;
+            if (r == end.row && c == end.col) return (uint32_t)grid.indexOf(r, c);
+            if (forcedVertical(grid, r, c, dr)) return (uint32_t)grid.indexOf(r, c);
+            if (scanHorizontal(grid, r, c + 1, 1, end) != NO_CELL ||
+                scanHorizontal(grid, r, c - 1, -1, end) != NO_CELL) {
+                return (uint32_t)grid.indexOf(r, c);
+            }
+        }
+    }
+
+    // JPS+ version of a jump from p in direction d
+    uint32_t lookupJump(const MazeGrid& grid, Point p, int d, Point end) const {
+        int value = jumpTable[d][grid.indexOf(p.row, p.col)];
+        int span = value > 0 ? value : -value; // Cells that can be walked
+        int best = value > 0 ? value : INT32_MAX;
+
+        if (d % 2 == 1) {
+            // Horizontal: only the goal itself can cut the run short
+            int toGoal = (end.col - p.col) * DIR_COL[d];
+            if (end.row == p.row && toGoal >= 1 && toGoal <= span) best = min(best, toGoal);
+        } else {
+            int toGoalRow = (end.row - p.row) * DIR_ROW[d];
+            if (toGoalRow >= 1 && toGoalRow <= span) {
+                if (end.col == p.col) {
+                    best = min(best, toGoalRow);
+                } else {
+                    // A horizontal scan from the goal's row would see the
+                    // goal if no wall comes first. (If it would stop at a
+                    // jump point, that row is already a jump point.)
+                    int side = end.col > p.col ? 1 : 3;
+                    int run = jumpTable[side][grid.indexOf(end.row, p.col)];
+                    if (run <= 0 && abs(end.col - p.col) <= -run) best = min(best, toGoalRow);
+                }
+            }
+        }
+
+        if (best == INT32_MAX) return NO_CELL;
+        return (uint32_t)grid.indexOf(p.row + DIR_ROW[d] * best, p.col + DIR_COL[d] * best);
+    }
+
+    uint32_t jump(const MazeGrid& grid, Point p, int d, Point end, bool precomputed) const {
+        if (precomputed) return lookupJump(grid, p, d, end);
+        if (d % 2 == 1) return scanHorizontal(grid, p.row, p.col + DIR_COL[d], DIR_COL[d], end);
+        return scanVertical(grid, p.row + DIR_ROW[d], p.col, DIR_ROW[d], end);
+    }
+
+    // Table entry for the run that starts with `next` (already known open)
+    static int16_t extendRun(bool nextIsJumpPoint, int16_t nextValue) {
+        if (nextIsJumpPoint) return 1;
+        return nextValue > 0 ? (int16_t)(nextValue + 1) : (int16_t)(nextValue - 1);
+    }
+
+public:
+    static const int MAX_TABLE_SIDE = 32767; // Distances are stored in 16 bits
+
+    JumpPointSolver() : tablesReady(false) {}
+
+    // Call whenever the walls change; frees the tables
+    void invalidate() {
+        tablesReady = false;
+        for (int d = 0; d < 4; d++) vector<int16_t>().swap(jumpTable[d]);
+    }
+
+    bool hasTables() const { return tablesReady; }
+
+    size_t tableBytes() const {
+        return tablesReady ? 4 * jumpTable[0].size() * sizeof(int16_t) : 0;
+    }
+
+    // Builds the JPS+ tables in O(cells); false if a side is too long
+    bool buildTables(const MazeGrid& grid) {
+        tablesReady = false;
+        int rows = grid.rows(), cols = grid.cols();
+        if (rows > MAX_TABLE_SIDE || cols > MAX_TABLE_SIDE) return false;
+        for (int d = 0; d < 4; d++) jumpTable[d].assign(grid.cellCount(), 0);
+
+        // Horizontal runs, each row from the far end back
+        for (int r = 0; r < rows; r++) {
+            for (int c = cols - 1; c >= 0; c--) {
+                size_t cell = grid.indexOf(r, c);
+                if (grid.isOpen(r, c + 1)) {
+                    jumpTable[1][cell] = extendRun(forcedHorizontal(grid, r, c + 1, 1), jumpTable[1][cell + 1]);
+                }
+            }
+            for (int c = 0; c < cols; c++) {
+                size_t cell = grid.indexOf(r, c);
+                if (grid.isOpen(r, c - 1)) {
+                    jumpTable[3][cell] = extendRun(forcedHorizontal(grid, r, c - 1, -1), jumpTable[3][cell - 1]);
+                }
+            }
+        }
+
+        // Vertical runs, a row at a time so memory is walked in order. A
+        // cell is a vertical jump point if it has a forced neighbour or a
+        // horizontal run from it reaches a jump point.
+        for (int r = rows - 1; r >= 0; r--) {
+            for (int c = 0; c < cols; c++) {
+                if (!grid.isOpen(r + 1, c)) continue;
+                size_t next = grid.indexOf(r + 1, c);
+                bool stop = forcedVertical(grid, r + 1, c, 1) || jumpTable[1][next] > 0 || jumpTable[3][next] > 0;
+                jumpTable[2][grid.indexOf(r, c)] = extendRun(stop, jumpTable[2][next]);
+            }
+        }
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                if (!grid.isOpen(r - 1, c)) continue;
+                size_t next = grid.indexOf(r - 1, c);
+                bool stop = forcedVertical(grid, r - 1, c, -1) || jumpTable[1][next] > 0 || jumpTable[3][next] > 0;
+                jumpTable[0][grid.indexOf(r, c)] = extendRun(stop, jumpTable[0][next]);
+            }
+        }
+
+        tablesReady = true;
+        return true;
+    }
+
+    // Fills path from start to end, every cell included; false if end is
+    // unreachable. `closed` is reset and marks expanded jump points. With
+    // precomputed set, uses (and if needed builds) the JPS+ tables,
+    // falling back to scanning if the maze is too large.
+    bool solve(const MazeGrid& grid, VisitedMarks& closed, Point start, Point end, vector<Point>& path,
+               SolveStats& stats, bool precomputed = false) {
+        if (precomputed && !tablesReady && !buildTables(grid)) precomputed = false;
+
+        SolveTimer timer;
+        stats = SolveStats();
+        path.clear();
+        closed.prepare(grid.cellCount());
+        nodes.clear();
+        open.clear();
+
+        uint32_t startCell = (uint32_t)grid.indexOf(start.row, start.col);
+        uint32_t target = (uint32_t)grid.indexOf(end.row, end.col);
+        if (!grid.isWallAt(startCell)) {
+            JumpNode first = {0, startCell, 4};
+            nodes[startCell] = first;
+            OpenItem item = {(uint32_t)manhattan(start, end), 0, startCell};
+            open.push_back(item);
+        }
+
+        bool found = false;
+        while (!open.empty()) {
+            pop_heap(open.begin(), open.end());
+            OpenItem item = open.back();
+            open.pop_back();
+            if (closed.isVisited(item.cell)) continue;
+            JumpNode node = nodes[item.cell];
+            if (item.g != node.g) continue; // A cheaper entry was pushed later
+
+            closed.visit(item.cell, 0);
+            stats.expanded++;
+            if (item.cell == target) {
+                found = true;
+                break;
+            }
+
+            // Straight on plus both sides; never back the way we came
+            Point curr = grid.pointOf(item.cell);
+            for (int d = 0; d < 4; d++) {
+                if (node.direction != 4 && d == (node.direction + 2) % 4) continue;
+
+                uint32_t next = jump(grid, curr, d, end, precomputed);
+                if (next == NO_CELL || closed.isVisited(next)) continue;
+
+                Point nextPoint = grid.pointOf(next);
+                uint32_t g = node.g + (uint32_t)manhattan(curr, nextPoint);
+                unordered_map<uint32_t, JumpNode>::iterator it = nodes.find(next);
+                if (it != nodes.end() && it->second.g <= g) continue;
+
+                JumpNode reached = {g, item.cell, (uint8_t)d};
+                nodes[next] = reached;
+                OpenItem pushed = {g + (uint32_t)manhattan(nextPoint, end), g, next};
+                open.push_back(pushed);
+                push_heap(open.begin(), open.end());
+            }
+        }
+
+        if (found) {
+            // Fill in the straight segments between jump points
+            uint32_t cell = target;
+            path.push_back(end);
+            while (cell != startCell) {
+                const JumpNode& node = nodes[cell];
+                Point p = grid.pointOf(cell);
+                Point back = grid.pointOf(node.parent);
+                while (!(p == back)) {
+                    p = Point(p.row - DIR_ROW[node.direction], p.col - DIR_COL[node.direction]);
+                    path.push_back(p);
+                }
+                cell = node.parent;
+            }
+            reverse(path.begin(), path.end());
+        }
+        stats.milliseconds = timer.elapsedMs();
+        return found;
+    }
+};
+
+#endif
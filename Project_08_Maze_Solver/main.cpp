@@ -2,94 +2,182 @@
  * ============================================================================
  * PROJECT #8: MAZE SOLVER & GENERATOR
  * ============================================================================
- * Data Structure: Graph (adjacency matrix), BFS, DFS algorithms
- * Features: Generate random maze, solve using BFS/DFS, visualize path
+ * Data Structure: Grid graph (bit-packed wall map), BFS, DFS, A*,
+ *                 bidirectional BFS, Jump Point Search (JPS/JPS+),
+ *                 BFS distance field with incremental updates
+ * Features: Generate random or perfect mazes (Kruskal, recursive
+ *           backtracker, Wilson), solve using several searches, visualize path
  * ============================================================================
  */
 
 #include <iostream>
-#include <queue>
-#include <stack>
+#include <iomanip>
+#include <string>
 #include <vector>
+#include <algorithm>
 #include <cstdlib>
 #include <ctime>
+#include <cstdint>
+#include "MazeGrid.h"
+#include "MazeSolvers.h"
+#include "MazeGenerators.h"
+#include "DistanceField.h"
 using namespace std;
 
-const int SIZE = 10;
-
-struct Point {
-    int row, col;
-    Point(int r = 0, int c = 0) : row(r), col(c) {}
-    bool operator==(const Point& other) const {
-        return row == other.row && col == other.col;
-    }
-};
+const int DEFAULT_SIZE = 10;
+const int DISPLAY_LIMIT = 60; // Larger mazes are summarized instead of drawn
 
 class Maze {
 private:
-    int grid[SIZE][SIZE];
+    MazeGrid grid;
     Point start, end;
-    bool visited[SIZE][SIZE];
+    VisitedMarks visited; // Shared by every search; also remembers how each cell was reached
+    AStarSolver aStar;
+    BidirectionalBFS bidirectional;
+    JumpPointSolver jumpPoints;
+    DistanceField field; // Distances to end, for repeated path queries
+
+    // Anything derived from the walls must be rebuilt
+    void wallsChanged() {
+        jumpPoints.invalidate();
+        field.invalidate();
+    }
 
-    // Direction vectors: Up, Right, Down, Left
-    int dr[4] = {-1, 0, 1, 0};
-    int dc[4] = {0, 1, 0, -1};
+    // Builds the distance field if it is missing or points elsewhere
+    void prepareDistanceField() {
+        if (field.isReady() && field.targetPoint() == end) return;
+        buildDistanceField();
+    }
 
-    bool isValid(int r, int c) {
-        return r >= 0 && r < SIZE && c >= 0 && c < SIZE;
+    // Builds the JPS+ tables if the walls changed since the last build
+    bool prepareJumpTables() {
+        if (jumpPoints.hasTables()) return true;
+        SolveTimer timer;
+        if (!jumpPoints.buildTables(grid)) {
+            cout << "\n⚠️  Maze too large for JPS+ tables (max side " << JumpPointSolver::MAX_TABLE_SIDE
+                 << "); scanning instead." << endl;
+            return false;
+        }
+        cout << "\n🛠️  Built JPS+ jump tables in " << timer.elapsedMs() << " ms ("
+             << jumpPoints.tableBytes() / 1024 << " KB)" << endl;
+        return true;
     }
 
     void resetVisited() {
-        for (int i = 0; i < SIZE; i++) {
-            for (int j = 0; j < SIZE; j++) {
-                visited[i][j] = false;
-            }
+        visited.reset();
+    }
+
+    // Follows the entry directions back from end, then puts start first
+    void tracePath(vector<Point>& path) const {
+        traceBack(grid, visited, end, start, path);
+        reverse(path.begin(), path.end());
+    }
+
+    // Prints the outcome of a solve, with the path drawn when it fits
+    void report(const string& solver, bool found, const vector<Point>& path, const SolveStats& stats) const {
+        if (!found) {
+            cout << "\n❌ No path found using " << solver << "! (" << stats.expanded << " cells expanded, "
+                 << stats.milliseconds << " ms)" << endl;
+            return;
         }
+        cout << "\n✅ Path found using " << solver << "! (Length: " << path.size() << ", "
+             << stats.expanded << " cells expanded, " << stats.milliseconds << " ms)" << endl;
+        displayWithPath(path);
     }
 
 public:
-    Maze() {
+    Maze(int rows = DEFAULT_SIZE, int cols = DEFAULT_SIZE) {
         srand(time(0));
+        resize(rows, cols);
         generateMaze();
     }
 
+    // Cell indices are 32-bit in the search queues
+    static bool validSize(int rows, int cols) {
+        return rows > 0 && cols > 0 && (uint64_t)rows * cols <= UINT32_MAX;
+    }
+
+    void resize(int rows, int cols) {
+        grid.resize(rows, cols);
+        visited.resize(grid.cellCount());
+        wallsChanged();
+        start = Point(0, 0);
+        end = Point(rows - 1, cols - 1);
+    }
+
+    int rows() const { return grid.rows(); }
+    int cols() const { return grid.cols(); }
+
     void generateMaze() {
-        // Initialize with walls
-        for (int i = 0; i < SIZE; i++) {
-            for (int j = 0; j < SIZE; j++) {
-                grid[i][j] = (rand() % 100 < 30) ? 1 : 0; // 30% walls
+        int rows = grid.rows(), cols = grid.cols();
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                grid.setWall(i, j, rand() % 100 < 30); // 30% walls
             }
         }
 
         // Set start and end
         start = Point(0, 0);
-        end = Point(SIZE - 1, SIZE - 1);
-        grid[start.row][start.col] = 0;
-        grid[end.row][end.col] = 0;
-
-        // Ensure at least one path exists (simple approach)
-        for (int i = 0; i < SIZE; i++) {
-            grid[i][i] = 0;
+        end = Point(rows - 1, cols - 1);
+        grid.setWall(start.row, start.col, false);
+        grid.setWall(end.row, end.col, false);
+
+        // Ensure at least one path exists (simple approach): a staircase
+        // down the diagonal, then straight along the last row or column
+        int diagonal = min(rows, cols);
+        for (int i = 0; i < diagonal; i++) {
+            grid.setWall(i, i, false);
+            if (i + 1 < rows) grid.setWall(i + 1, i, false);
         }
+        for (int i = diagonal; i < rows; i++) grid.setWall(i, cols - 1, false);
+        for (int j = diagonal; j < cols; j++) grid.setWall(rows - 1, j, false);
+        wallsChanged();
 
         cout << "✅ New maze generated!" << endl;
     }
 
-    void displayMaze() const {
+    // Perfect maze (exactly one route between any two rooms); the same
+    // seed always gives the same maze
+    void generatePerfectMaze(MazeAlgorithm algorithm, uint64_t seed) {
+        SolveTimer timer;
+        MazeGenerator generator(seed);
+        generator.generate(grid, algorithm);
+        start = Point(0, 0);
+        end = MazeGenerator::lastRoom(grid);
+        wallsChanged();
+
+        const char* names[] = {"", "Kruskal", "Recursive backtracker", "Wilson"};
+        cout << "✅ " << names[algorithm] << " maze generated in " << timer.elapsedMs()
+             << " ms (seed " << seed << ")" << endl;
+    }
+
+    void displayMaze(const vector<Point>* path = nullptr) const {
+        int rows = grid.rows(), cols = grid.cols();
+        if (rows > DISPLAY_LIMIT || cols > DISPLAY_LIMIT) {
+            cout << "\n  Maze is " << rows << " x " << cols << " (" << grid.cellCount() << " cells, "
+                 << grid.memoryBytes() / 1024 << " KB of walls) - too large to draw." << endl;
+            return;
+        }
+
+        vector<bool> onPath(path != nullptr ? grid.cellCount() : 0, false);
+        if (path != nullptr) {
+            for (const Point& p : *path) onPath[grid.indexOf(p.row, p.col)] = true;
+        }
+
         cout << "\n  ";
-        for (int i = 0; i < SIZE; i++) cout << "══";
+        for (int i = 0; i < cols; i++) cout << "══";
         cout << "\n";
 
-        for (int i = 0; i < SIZE; i++) {
+        for (int i = 0; i < rows; i++) {
             cout << "  ";
-            for (int j = 0; j < SIZE; j++) {
+            for (int j = 0; j < cols; j++) {
                 if (i == start.row && j == start.col) {
                     cout << "S "; // Start
                 } else if (i == end.row && j == end.col) {
                     cout << "E "; // End
-                } else if (grid[i][j] == 1) {
+                } else if (grid.isWall(i, j)) {
                     cout << "# "; // Wall
-                } else if (grid[i][j] == 2) {
+                } else if (path != nullptr && onPath[grid.indexOf(i, j)]) {
                     cout << ". "; // Path
                 } else {
                     cout << "  "; // Open space
@@ -99,126 +187,249 @@ public:
         }
 
         cout << "  ";
-        for (int i = 0; i < SIZE; i++) cout << "══";
+        for (int i = 0; i < cols; i++) cout << "══";
         cout << "\n";
     }
 
-    void displayWithPath(const vector<Point>& path) {
-        // Mark path
-        for (const Point& p : path) {
-            if (!(p == start) && !(p == end)) {
-                grid[p.row][p.col] = 2;
-            }
-        }
+    void displayWithPath(const vector<Point>& path) const {
+        displayMaze(&path);
+    }
 
-        displayMaze();
+    // Fills path from start to end; shortest
+    bool runBFS(vector<Point>& path, SolveStats& stats) {
+        SolveTimer timer;
+        stats = SolveStats();
+        path.clear();
+        resetVisited();
+        // Level by level, so only the current frontier is held in memory
+        vector<uint32_t> frontier, next;
+        size_t target = grid.indexOf(end.row, end.col);
+
+        frontier.push_back((uint32_t)grid.indexOf(start.row, start.col));
+        visited.visit(frontier[0], 0);
+
+        bool found = false;
+        while (!frontier.empty() && !found) {
+            for (size_t k = 0; k < frontier.size() && !found; k++) {
+                if (frontier[k] == target) {
+                    found = true;
+                    break;
+                }
 
-        // Clean up path markers
-        for (const Point& p : path) {
-            if (!(p == start) && !(p == end)) {
-                grid[p.row][p.col] = 0;
+                // Explore neighbors
+                stats.expanded++;
+                Point curr = grid.pointOf(frontier[k]);
+                for (int i = 0; i < 4; i++) {
+                    int newR = curr.row + DIR_ROW[i];
+                    int newC = curr.col + DIR_COL[i];
+                    if (!grid.isOpen(newR, newC)) continue;
+
+                    size_t index = grid.indexOf(newR, newC);
+                    if (!visited.isVisited(index)) {
+                        visited.visit(index, i);
+                        next.push_back((uint32_t)index);
+                    }
+                }
             }
+            frontier.swap(next);
+            next.clear();
         }
+
+        if (found) tracePath(path);
+        stats.milliseconds = timer.elapsedMs();
+        return found;
     }
 
-    bool solveBFS() {
+    // Fills path from start to end; any path, not necessarily the shortest
+    bool runDFS(vector<Point>& path, SolveStats& stats) {
+        SolveTimer timer;
+        stats = SolveStats();
+        path.clear();
         resetVisited();
-        queue<Point> q;
-        Point parent[SIZE][SIZE];
-        
-        q.push(start);
-        visited[start.row][start.col] = true;
-        parent[start.row][start.col] = Point(-1, -1);
-
-        while (!q.empty()) {
-            Point curr = q.front();
-            q.pop();
-
-            if (curr == end) {
-                // Reconstruct path
-                vector<Point> path;
-                Point p = end;
-                while (!(p == Point(-1, -1))) {
-                    path.push_back(p);
-                    p = parent[p.row][p.col];
-                }
+        vector<uint32_t> s;
+        size_t target = grid.indexOf(end.row, end.col);
+
+        s.push_back((uint32_t)grid.indexOf(start.row, start.col));
+        visited.visit(s[0], 0);
 
-                cout << "\n✅ Path found using BFS! (Length: " << path.size() << ")" << endl;
-                displayWithPath(path);
-                return true;
+        bool found = false;
+        while (!s.empty()) {
+            size_t currIndex = s.back();
+            s.pop_back();
+
+            if (currIndex == target) {
+                found = true;
+                break;
             }
 
             // Explore neighbors
+            stats.expanded++;
+            Point curr = grid.pointOf(currIndex);
             for (int i = 0; i < 4; i++) {
-                int newR = curr.row + dr[i];
-                int newC = curr.col + dc[i];
-
-                if (isValid(newR, newC) && !visited[newR][newC] && grid[newR][newC] == 0) {
-                    visited[newR][newC] = true;
-                    q.push(Point(newR, newC));
-                    parent[newR][newC] = curr;
+                int newR = curr.row + DIR_ROW[i];
+                int newC = curr.col + DIR_COL[i];
+                if (!grid.isOpen(newR, newC)) continue;
+
+                size_t index = grid.indexOf(newR, newC);
+                if (!visited.isVisited(index)) {
+                    visited.visit(index, i);
+                    s.push_back((uint32_t)index);
                 }
             }
         }
 
-        cout << "\n❌ No path found using BFS!" << endl;
-        return false;
+        if (found) tracePath(path);
+        stats.milliseconds = timer.elapsedMs();
+        return found;
+    }
+
+    bool solveBFS() {
+        vector<Point> path;
+        SolveStats stats;
+        bool found = runBFS(path, stats);
+        report("BFS", found, path, stats);
+        return found;
     }
 
     bool solveDFS() {
-        resetVisited();
-        stack<Point> s;
-        Point parent[SIZE][SIZE];
-        
-        s.push(start);
-        visited[start.row][start.col] = true;
-        parent[start.row][start.col] = Point(-1, -1);
+        vector<Point> path;
+        SolveStats stats;
+        bool found = runDFS(path, stats);
+        report("DFS", found, path, stats);
+        return found;
+    }
 
-        while (!s.empty()) {
-            Point curr = s.top();
-            s.pop();
-
-            if (curr == end) {
-                // Reconstruct path
-                vector<Point> path;
-                Point p = end;
-                while (!(p == Point(-1, -1))) {
-                    path.push_back(p);
-                    p = parent[p.row][p.col];
-                }
+    bool solveAStar() {
+        vector<Point> path;
+        SolveStats stats;
+        bool found = aStar.solve(grid, visited, start, end, path, stats);
+        report("A*", found, path, stats);
+        return found;
+    }
 
-                cout << "\n✅ Path found using DFS! (Length: " << path.size() << ")" << endl;
-                displayWithPath(path);
-                return true;
-            }
+    bool solveBidirectional() {
+        vector<Point> path;
+        SolveStats stats;
+        bool found = bidirectional.solve(grid, visited, start, end, path, stats);
+        report("Bidirectional BFS", found, path, stats);
+        return found;
+    }
 
-            // Explore neighbors
-            for (int i = 0; i < 4; i++) {
-                int newR = curr.row + dr[i];
-                int newC = curr.col + dc[i];
+    bool solveJPS(bool precomputed) {
+        if (precomputed) precomputed = prepareJumpTables();
+        vector<Point> path;
+        SolveStats stats;
+        bool found = jumpPoints.solve(grid, visited, start, end, path, stats, precomputed);
+        report(precomputed ? "JPS+" : "Jump Point Search", found, path, stats);
+        return found;
+    }
 
-                if (isValid(newR, newC) && !visited[newR][newC] && grid[newR][newC] == 0) {
-                    visited[newR][newC] = true;
-                    s.push(Point(newR, newC));
-                    parent[newR][newC] = curr;
-                }
-            }
+    void buildDistanceField() {
+        SolveTimer timer;
+        field.build(grid, end);
+        cout << "\n✅ Distance field to E built in " << timer.elapsedMs() << " ms ("
+             << field.memoryBytes() / 1024 << " KB)" << endl;
+    }
+
+    // Shortest path length from any cell in O(1), path by gradient descent
+    bool pathFrom(Point from) {
+        if (!grid.inBounds(from.row, from.col)) {
+            cout << "\n❌ Cell is outside the maze!" << endl;
+            return false;
+        }
+        prepareDistanceField();
+
+        SolveTimer timer;
+        uint32_t steps = field.distanceFrom(grid, from);
+        if (steps == UNREACHABLE) {
+            cout << "\n❌ E cannot be reached from (" << from.row << ", " << from.col << ")!" << endl;
+            return false;
         }
+        vector<Point> path;
+        field.pathFrom(grid, from, path);
+        cout << "\n📏 Shortest path from (" << from.row << ", " << from.col << ") to E: " << steps
+             << " steps (" << timer.elapsedMs() << " ms)" << endl;
+        displayWithPath(path);
+        return true;
+    }
 
-        cout << "\n❌ No path found using DFS!" << endl;
-        return false;
+    // Flips one cell and updates the distance field incrementally
+    void toggleWall(int r, int c) {
+        if (!grid.inBounds(r, c) || Point(r, c) == start || Point(r, c) == end) {
+            cout << "\n❌ Cannot toggle that cell!" << endl;
+            return;
+        }
+        bool wall = !grid.isWall(r, c);
+        grid.setWall(r, c, wall);
+        jumpPoints.invalidate();
+        cout << "\n✅ (" << r << ", " << c << ") is now " << (wall ? "a wall" : "open") << endl;
+
+        if (!field.isReady()) return;
+        SolveTimer timer;
+        size_t updated = wall ? field.wallAdded(grid, Point(r, c)) : field.wallRemoved(grid, Point(r, c));
+        cout << "🔁 Distance field updated: " << updated << " cells in " << timer.elapsedMs() << " ms" << endl;
+    }
+
+    // Runs every solver on the current maze and tabulates the results
+    void compareSolvers() {
+        bool tables = prepareJumpTables();
+        streamsize oldPrecision = cout.precision();
+        cout << "\n  " << left << setw(20) << "Solver" << right << setw(10) << "Length"
+             << setw(14) << "Expanded" << setw(12) << "Time (ms)" << endl;
+        cout << "  " << string(56, '-') << endl;
+
+        const char* names[] = {"BFS", "DFS", "A*", "Bidirectional BFS", "Jump Point Search", "JPS+"};
+        for (int k = 0; k < (tables ? 6 : 5); k++) {
+            vector<Point> path;
+            SolveStats stats;
+            bool found = false;
+            if (k == 0) found = runBFS(path, stats);
+            else if (k == 1) found = runDFS(path, stats);
+            else if (k == 2) found = aStar.solve(grid, visited, start, end, path, stats);
+            else if (k == 3) found = bidirectional.solve(grid, visited, start, end, path, stats);
+            else found = jumpPoints.solve(grid, visited, start, end, path, stats, k == 5);
+
+            cout << "  " << left << setw(20) << names[k] << right << setw(10);
+            if (found) cout << path.size();
+            else cout << "-";
+            cout << setw(14) << stats.expanded << setw(12) << fixed << setprecision(2)
+                 << stats.milliseconds << endl;
+        }
+        cout.unsetf(ios::fixed);
+        cout.precision(oldPrecision);
+        bool fieldRow = field.isReady() && field.targetPoint() == end;
+        if (fieldRow) {
+            SolveTimer timer;
+            vector<Point> path;
+            bool found = field.pathFrom(grid, start, path);
+            double ms = timer.elapsedMs();
+            // Nothing is expanded: the path is read off the precomputed field
+            cout << "  " << left << setw(20) << "Distance field" << right << setw(10);
+            if (found) cout << path.size();
+            else cout << "-";
+            cout << setw(14) << "-" << setw(12) << fixed << setprecision(2) << ms << endl;
+            cout.unsetf(ios::fixed);
+            cout.precision(oldPrecision);
+        }
+        cout << "  (DFS paths are not necessarily shortest)" << endl;
+        if (fieldRow) {
+            cout << "  (Distance field is a lookup in a field built beforehand, not a search)" << endl;
+        }
     }
 
     void setCustomMaze() {
         cout << "\n  Enter maze (0=path, 1=wall):" << endl;
-        for (int i = 0; i < SIZE; i++) {
+        for (int i = 0; i < grid.rows(); i++) {
             cout << "  Row " << i << ": ";
-            for (int j = 0; j < SIZE; j++) {
-                cin >> grid[i][j];
+            for (int j = 0; j < grid.cols(); j++) {
+                int cell;
+                cin >> cell;
+                grid.setWall(i, j, cell == 1);
             }
         }
-        grid[start.row][start.col] = 0;
-        grid[end.row][end.col] = 0;
+        grid.setWall(start.row, start.col, false);
+        grid.setWall(end.row, end.col, false);
+        wallsChanged();
         cout << "✅ Custom maze set!" << endl;
     }
 };
@@ -237,8 +448,17 @@ int main() {
         cout << "  2. Generate New Maze\n";
         cout << "  3. Solve using BFS (Breadth-First Search)\n";
         cout << "  4. Solve using DFS (Depth-First Search)\n";
-        cout << "  5. Set Custom Maze\n";
-        cout << "  6. Exit\n";
+        cout << "  5. Solve using A* (Manhattan heuristic)\n";
+        cout << "  6. Solve using Bidirectional BFS\n";
+        cout << "  7. Solve using Jump Point Search\n";
+        cout << "  8. Solve using JPS+ (precomputed jumps)\n";
+        cout << "  9. Compare Solvers\n";
+        cout << "  10. Set Custom Maze\n";
+        cout << "  11. Set Maze Size\n";
+        cout << "  12. Build Distance Field to End\n";
+        cout << "  13. Shortest Path From Cell\n";
+        cout << "  14. Toggle Wall\n";
+        cout << "  15. Exit\n";
         cout << "  Choice: ";
         cin >> choice;
 
@@ -246,7 +466,23 @@ int main() {
             maze.displayMaze();
         }
         else if (choice == 2) {
-            maze.generateMaze();
+            int algorithm;
+            unsigned long long seed;
+            cout << "  1. Random walls  2. Kruskal  3. Recursive backtracker  4. Wilson\n";
+            cout << "  Algorithm: ";
+            cin >> algorithm;
+            if (algorithm < 1 || algorithm > 4) {
+                cout << "❌ Invalid algorithm!" << endl;
+                continue;
+            }
+            if (algorithm == 1) {
+                maze.generateMaze();
+            } else {
+                cout << "  Seed (0 = random): ";
+                cin >> seed;
+                if (seed == 0) seed = (unsigned long long)time(0) * 2654435761ULL + rand();
+                maze.generatePerfectMaze((MazeAlgorithm)(algorithm - 1), seed);
+            }
             maze.displayMaze();
         }
         else if (choice == 3) {
@@ -256,9 +492,53 @@ int main() {
             maze.solveDFS();
         }
         else if (choice == 5) {
-            maze.setCustomMaze();
+            maze.solveAStar();
         }
         else if (choice == 6) {
+            maze.solveBidirectional();
+        }
+        else if (choice == 7) {
+            maze.solveJPS(false);
+        }
+        else if (choice == 8) {
+            maze.solveJPS(true);
+        }
+        else if (choice == 9) {
+            maze.compareSolvers();
+        }
+        else if (choice == 10) {
+            maze.setCustomMaze();
+        }
+        else if (choice == 11) {
+            int rows, cols;
+            cout << "  Rows: ";
+            cin >> rows;
+            cout << "  Columns: ";
+            cin >> cols;
+            if (!Maze::validSize(rows, cols)) {
+                cout << "❌ Invalid maze size!" << endl;
+                continue;
+            }
+            maze.resize(rows, cols);
+            maze.generateMaze();
+            maze.displayMaze();
+        }
+        else if (choice == 12) {
+            maze.buildDistanceField();
+        }
+        else if (choice == 13) {
+            int r, c;
+            cout << "  Row and column: ";
+            cin >> r >> c;
+            maze.pathFrom(Point(r, c));
+        }
+        else if (choice == 14) {
+            int r, c;
+            cout << "  Row and column: ";
+            cin >> r >> c;
+            maze.toggleWall(r, c);
+        }
+        else if (choice == 15) {
             cout << "\n  🧩 Thanks for using Maze Solver!\n";
             break;
         }
@@ -26,7 +26,7 @@ foreach ($project in $projects) {
     
     Push-Location $project.Name
     
-    $result = g++ -std=c++11 main.cpp -o "$($project.Output).exe" 2>&1
+    $result = g++ -std=c++11 -pthread main.cpp -o "$($project.Output).exe" 2>&1
     
     if ($LASTEXITCODE -eq 0) {
         Write-Host " [OK]" -ForegroundColor Green
@@ -31,7 +31,7 @@ for project in "${projects[@]}"; do
     
     cd "$folder" || exit
     
-    if g++ -std=c++11 main.cpp -o "$output" 2>/dev/null; then
+    if g++ -std=c++11 -pthread main.cpp -o "$output" 2>/dev/null; then
         echo " [OK]"
         ((success++))
     else